@@ -0,0 +1,28 @@
+// instanced_cube.glsl
+
+#version 330 core
+// Cubo unitário (centrado na origem) desenhado uma vez por bloco exposto dos
+// chunks esparsos. Cada instância é um registro de 32 bits (ver ChunkInstance
+// em src/chunk.h):
+//   x | y << 5 | z << 11 | tipo << 16
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec2 aTexCoords;
+layout(location = 2) in uint aInstance;
+
+out vec2 TexCoords;
+flat out int BlockType; // Usa 'flat' para evitar interpolação
+
+uniform ivec3 chunkOrigin; // Canto do chunk no mundo, em blocos
+uniform mat4 view;
+uniform mat4 projection;
+
+void main() {
+    vec3 block = vec3(float(aInstance & 31u),
+                      float((aInstance >> 5) & 63u),
+                      float((aInstance >> 11) & 31u));
+
+    TexCoords = aTexCoords;
+    BlockType = int((aInstance >> 16) & 7u);
+    gl_Position = projection * view *
+                  vec4(vec3(chunkOrigin) + block + aPos + 0.5, 1.0);
+}
@@ -0,0 +1,84 @@
+// mesher_compute.glsl
+
+#version 430 core
+// Gerador de malha na GPU: um quad por face exposta, como MESH_MODE_FACES em
+// src/mesher.c. Cada invocação cuida de um bloco do chunk. Roda em duas
+// passadas: a primeira (emitQuads = 0) só conta as faces de cada grupo
+// (seção, face) e acha o plano limite do grupo; a segunda escreve os quads
+// no VBO do chunk, a partir do cursor de cada grupo. Os registros seguem o
+// layout de ChunkQuad em src/chunk.h.
+layout(local_size_x = 8, local_size_y = 8, local_size_z = 8) in;
+
+// Saída: o VBO do chunk, já com as faixas de cada seção
+layout(std430, binding = 0) writeonly buffer Quads {
+    uint quads[];
+};
+
+// Entrada: o começo de um ChunkSnapshot, ou seja, os tipos dos blocos (quatro
+// por palavra, na ordem [x][y][z]) e as colunas de solidez dos vizinhos
+// (X-, X+, Z-, Z+, 32 colunas de 64 bits cada)
+layout(std430, binding = 1) readonly buffer Blocks {
+    uint types[32 * 64 * 32 / 4];
+    uvec2 halos[4 * 32];
+};
+
+// Um contador, um plano e um cursor por grupo, na ordem seção * 6 + face
+layout(std430, binding = 2) buffer Groups {
+    uint counts[24];
+    int planes[24];
+    uint cursors[24];
+};
+
+uniform int emitQuads;
+
+// Vizinho de cada face, na ordem X+, X-, Y+, Y-, Z+, Z-
+const ivec3 faceDirections[6] = ivec3[6](
+    ivec3(1, 0, 0), ivec3(-1, 0, 0), ivec3(0, 1, 0),
+    ivec3(0, -1, 0), ivec3(0, 0, 1), ivec3(0, 0, -1));
+
+uint blockType(ivec3 p) {
+    int i = (p.x * 64 + p.y) * 32 + p.z;
+    return (types[i >> 2] >> ((i & 3) * 8)) & 255u;
+}
+
+bool haloSolid(int column, int y) {
+    uvec2 bits = halos[column];
+    return ((y < 32 ? bits.x >> y : bits.y >> (y - 32)) & 1u) != 0u;
+}
+
+// Solidez de qualquer posição vizinha a um bloco do chunk: fora dele, em X e
+// Z, vale a borda do vizinho; acima e abaixo é ar
+bool solid(ivec3 p) {
+    if (p.y < 0 || p.y >= 64) return false;
+    if (p.x < 0) return haloSolid(p.z, p.y);
+    if (p.x >= 32) return haloSolid(32 + p.z, p.y);
+    if (p.z < 0) return haloSolid(64 + p.x, p.y);
+    if (p.z >= 32) return haloSolid(96 + p.x, p.y);
+    return blockType(p) != 0u;
+}
+
+void main() {
+    ivec3 p = ivec3(gl_GlobalInvocationID);
+    uint type = blockType(p);
+    if (type == 0u) return;
+
+    for (int f = 0; f < 6; f++) {
+        if (solid(p + faceDirections[f])) continue;
+        int group = (p.y / 16) * 6 + f;
+        if (emitQuads == 0) {
+            // Faces pares apontam para o lado positivo: o plano fica depois
+            // do bloco, e o grupo guarda o menor; nas ímpares, o maior
+            int axis = f / 2;
+            atomicAdd(counts[group], 1u);
+            if (f % 2 == 0) {
+                atomicMin(planes[group], p[axis] + 1);
+            } else {
+                atomicMax(planes[group], p[axis]);
+            }
+        } else {
+            uint index = atomicAdd(cursors[group], 1u);
+            quads[index] = uint(p.x) | uint(p.y) << 5 | uint(p.z) << 11 |
+                           uint(f) << 16 | type << 19;
+        }
+    }
+}
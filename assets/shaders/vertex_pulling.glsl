@@ -0,0 +1,57 @@
+// vertex_pulling.glsl
+
+#version 430 core
+// Sem atributos de vértice: cada quad é um registro de 32 bits no storage
+// buffer (ver ChunkQuad em src/chunk.h) e os quatro cantos saem de
+// gl_VertexID (quad = id / 4, canto = id % 4):
+//   x | y << 5 | z << 11 | face << 16 | tipo << 19 | (largura - 1) << 22 |
+//   (altura - 1) << 27
+layout(std430, binding = 0) readonly buffer Quads {
+    uint quads[];
+};
+
+out vec2 TexCoords;
+flat out int BlockType; // Usa 'flat' para evitar interpolação
+
+uniform ivec3 chunkOrigin; // Canto do chunk no mundo, em blocos
+uniform mat4 view;
+uniform mat4 projection;
+
+// Cantos de cada face em sentido anti-horário visto de fora do bloco, na
+// ordem X+, X-, Y+, Y-, Z+, Z- (a mesma da tabela faces[] em src/mesher.c)
+const vec3 faceCorners[24] = vec3[24](
+    vec3(1, 0, 1), vec3(1, 0, 0), vec3(1, 1, 0), vec3(1, 1, 1),
+    vec3(0, 0, 0), vec3(0, 0, 1), vec3(0, 1, 1), vec3(0, 1, 0),
+    vec3(0, 1, 1), vec3(1, 1, 1), vec3(1, 1, 0), vec3(0, 1, 0),
+    vec3(0, 0, 0), vec3(1, 0, 0), vec3(1, 0, 1), vec3(0, 0, 1),
+    vec3(0, 0, 1), vec3(1, 0, 1), vec3(1, 1, 1), vec3(0, 1, 1),
+    vec3(1, 0, 0), vec3(0, 0, 0), vec3(0, 1, 0), vec3(1, 1, 0));
+
+// Eixos u e v da textura para as faces de cada eixo (X, Y, Z)
+const ivec2 faceAxes[3] = ivec2[3](ivec2(2, 1), ivec2(0, 2), ivec2(0, 1));
+
+// Coordenadas de textura de cada canto do quad, antes de escalar pelo tamanho
+const vec2 cornerTexCoords[4] = vec2[4](
+    vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0), vec2(0.0, 1.0));
+
+void main() {
+    uint quad = quads[gl_VertexID >> 2];
+    int corner = gl_VertexID & 3;
+
+    vec3 origin = vec3(float(quad & 31u),
+                       float((quad >> 5) & 63u),
+                       float((quad >> 11) & 31u));
+    int face = int((quad >> 16) & 7u);
+    vec2 size = vec2(float(((quad >> 22) & 31u) + 1u),
+                     float(((quad >> 27) & 31u) + 1u));
+
+    vec3 extent = vec3(1.0);
+    ivec2 axes = faceAxes[face / 2];
+    extent[axes.x] = size.x;
+    extent[axes.y] = size.y;
+    vec3 position = origin + faceCorners[face * 4 + corner] * extent;
+
+    TexCoords = cornerTexCoords[corner] * size;
+    BlockType = int((quad >> 19) & 7u);
+    gl_Position = projection * view * vec4(vec3(chunkOrigin) + position, 1.0);
+}
@@ -1,19 +1,31 @@
 // vertex_shader.glsl
 
 #version 330 core
-layout(location = 0) in vec3 aPos;
-layout(location = 1) in vec2 aTexCoords;
-layout(location = 2) in int aBlockType;
+// Vértice compactado (ver ChunkVertex em src/chunk.h):
+//   aPacked.x (position): x | y << 6 | z << 13 | face << 19 | canto << 22
+//   aPacked.y (material): tipo do bloco | largura << 8 | altura << 15
+layout(location = 0) in uvec2 aPacked;
 
 out vec2 TexCoords;
 flat out int BlockType; // Usa 'flat' para evitar interpolação
 
-uniform mat4 model;
+uniform ivec3 chunkOrigin; // Canto do chunk no mundo, em blocos
 uniform mat4 view;
 uniform mat4 projection;
 
+// Coordenadas de textura de cada canto do quad, antes de escalar pelo tamanho
+const vec2 cornerTexCoords[4] = vec2[4](
+    vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0), vec2(0.0, 1.0));
+
 void main() {
-    TexCoords = aTexCoords;
-    BlockType = aBlockType;
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    vec3 position = vec3(float(aPacked.x & 63u),
+                         float((aPacked.x >> 6) & 127u),
+                         float((aPacked.x >> 13) & 63u));
+    uint corner = (aPacked.x >> 22) & 3u;
+    vec2 size = vec2(float((aPacked.y >> 8) & 127u),
+                     float((aPacked.y >> 15) & 127u));
+
+    TexCoords = cornerTexCoords[corner] * size;
+    BlockType = int(aPacked.y & 255u);
+    gl_Position = projection * view * vec4(vec3(chunkOrigin) + position, 1.0);
 }
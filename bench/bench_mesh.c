@@ -0,0 +1,563 @@
+// bench/bench_mesh.c
+//
+// Benchmark e verificação do gerador de malha, sem janela nem OpenGL. Roda
+// cada gerador (faces, greedy e cubos instanciados) sobre um catálogo de
+// chunks sintéticos, com e sem vizinhos e em cada nível de detalhe, e mede o
+// tempo por voxel, os quads (ou cubos), triângulos e bytes gerados e as
+// alocações por chunk. Os geradores são medidos sem o cache de malhas, e o
+// que o cache acrescenta numa falta (+cache, +allocs) sai à parte. Os
+// triângulos dos cubos aparecem também quando o gerador os recusa, para
+// comparar os dois caminhos. Cada saída é comparada com uma referência de
+// força bruta, escrita aqui sem reaproveitar nada de src/mesher.c: a
+// superfície visível (cada face exposta, no nível de detalhe do caso, com o
+// tipo do bloco) precisa sair coberta exatamente uma vez. Sai com código 1 se
+// alguma comparação falhar.
+//
+// Uso: make bench-mesh
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "chunk.h"
+#include "mesh_cache.h"
+#include "mesher.h"
+
+// Tempo mínimo de medição de cada combinação de chunk e gerador
+#define BENCH_MIN_SECONDS 0.1
+
+#define VOXELS (CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_DEPTH)
+
+// Acima disso os cubos instanciados nem entram na tabela (chunks cheios)
+#define BENCH_MAX_INSTANCES 2048
+
+// Alocações, contadas pelos wrappers do linker (-Wl,--wrap=malloc, ...)
+static size_t allocations = 0;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* pointer, size_t size);
+
+void* __wrap_malloc(size_t size) {
+  allocations++;
+  return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+  allocations++;
+  return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* pointer, size_t size) {
+  allocations++;
+  return __real_realloc(pointer, size);
+}
+
+// Catálogo de chunks. As cenas são definidas em coordenadas do mundo e valem
+// também alguns blocos para fora do chunk, de onde saem as bordas dos vizinhos
+// quando o caso tem vizinhos; sem vizinhos o chunk fica na borda do mundo e as
+// paredes laterais também contam como superfície
+
+// Hash da posição, para o ruído ser o mesmo em toda execução e dentro e fora
+// do chunk
+static uint32_t hash_position(int x, int y, int z) {
+  uint32_t value = (uint32_t)x * 73856093u ^ (uint32_t)y * 19349663u ^
+                   (uint32_t)z * 83492791u;
+  value ^= value >> 13;
+  value *= 0x5bd1e995u;
+  return value ^ value >> 15;
+}
+
+// Camadas como em chunk_create: pedra, terra e grama até y = 25
+static uint8_t scene_default(int x, int y, int z) {
+  (void)x;
+  (void)z;
+  if (y < 20) return BLOCK_STONE;
+  if (y < 25) return BLOCK_DIRT;
+  if (y == 25) return BLOCK_GRASS;
+  return BLOCK_AIR;
+}
+
+static uint8_t scene_air(int x, int y, int z) {
+  (void)x;
+  (void)y;
+  (void)z;
+  return BLOCK_AIR;
+}
+
+static uint8_t scene_solid(int x, int y, int z) {
+  (void)x;
+  (void)y;
+  (void)z;
+  return BLOCK_STONE;
+}
+
+// Pior caso: nenhum bloco encosta em outro, todas as faces ficam expostas
+static uint8_t scene_checkerboard(int x, int y, int z) {
+  return (x + y + z) & 1 ? BLOCK_AIR : BLOCK_DIRT;
+}
+
+// Metade dos blocos sólidos, com tipos sorteados
+static uint8_t scene_noise(int x, int y, int z) {
+  uint32_t value = hash_position(x, y, z);
+  return value % 2 ? BLOCK_AIR : (uint8_t)(1 + value / 2 % 3);
+}
+
+// Colunas finas e esparsas de alturas variadas, sem chão
+static uint8_t scene_pillars(int x, int y, int z) {
+  if ((x & 7) != 3 || (z & 7) != 3) return BLOCK_AIR;
+  int height = 8 + ((x * 7 + z * 13) % 40 + 40) % 40;
+  return y < height ? BLOCK_STONE : BLOCK_AIR;
+}
+
+// Blocos soltos, sem nenhum vizinho sólido: nem a malha gulosa funde faces,
+// é o caso para o qual existem os cubos instanciados
+static uint8_t scene_floating(int x, int y, int z) {
+  if ((x & 3) != 1 || (y & 7) != 1 || (z & 3) != 1) return BLOCK_AIR;
+  return (uint8_t)(1 + hash_position(x, y, z) % 3);
+}
+
+// Emenda entre chunks: metade de baixo do chunk sólida e, nos vizinhos, só a
+// coluna encostada no chunk, em camadas alternadas. Nos níveis de detalhe a
+// célula vizinha tem metade da fatia da borda sólida mas é ar pelo volume, e a
+// face do chunk precisa continuar lá
+static uint8_t scene_seam(int x, int y, int z) {
+  int inside_x = x >= 0 && x < CHUNK_WIDTH;
+  int inside_z = z >= 0 && z < CHUNK_DEPTH;
+  if (inside_x && inside_z) {
+    return y < CHUNK_HEIGHT / 2 ? BLOCK_STONE : BLOCK_AIR;
+  }
+  int border = x == -1 || x == CHUNK_WIDTH || z == -1 || z == CHUNK_DEPTH;
+  return border && y % 2 == 0 ? BLOCK_DIRT : BLOCK_AIR;
+}
+
+typedef struct {
+  const char* name;
+  uint8_t (*type_at)(int x, int y, int z);
+  int lod;
+  int neighbors;  // Se as bordas dos vizinhos vêm da cena ou ficam vazias
+} BenchCase;
+
+static const BenchCase cases[] = {
+    {"default", scene_default, 0, 0},
+    {"air", scene_air, 0, 0},
+    {"solid", scene_solid, 0, 0},
+    {"checkerboard", scene_checkerboard, 0, 0},
+    {"noise", scene_noise, 0, 0},
+    {"pillars", scene_pillars, 0, 0},
+    {"floating", scene_floating, 0, 0},
+    {"default", scene_default, 0, 1},
+    {"default", scene_default, 1, 1},
+    {"default", scene_default, 2, 1},
+    {"noise", scene_noise, 0, 1},
+    {"noise", scene_noise, 1, 1},
+    {"noise", scene_noise, 2, 1},
+    {"pillars", scene_pillars, 1, 1},
+    {"pillars", scene_pillars, 2, 1},
+    {"seam", scene_seam, 0, 1},
+    {"seam", scene_seam, 1, 1},
+    {"seam", scene_seam, 2, 1},
+};
+
+// Bloco do caso em coordenadas do mundo; fora do chunk só existe vizinho se o
+// caso tiver vizinhos, e acima e abaixo do chunk é sempre ar
+static uint8_t case_block(const BenchCase* bench, int x, int y, int z) {
+  if (y < 0 || y >= CHUNK_HEIGHT) return BLOCK_AIR;
+  int inside = x >= 0 && x < CHUNK_WIDTH && z >= 0 && z < CHUNK_DEPTH;
+  if (!inside && !bench->neighbors) return BLOCK_AIR;
+  return bench->type_at(x, y, z);
+}
+
+static uint64_t case_column(const BenchCase* bench, int x, int z) {
+  uint64_t mask = 0;
+  for (int y = 0; y < CHUNK_HEIGHT; y++) {
+    mask |= (uint64_t)(case_block(bench, x, y, z) != BLOCK_AIR) << y;
+  }
+  return mask;
+}
+
+// Monta o snapshot como chunk_snapshot faria com os vizinhos da cena
+static void build_snapshot(const BenchCase* bench, ChunkSnapshot* snapshot) {
+  memset(snapshot, 0, sizeof(ChunkSnapshot));
+  for (int x = 0; x < CHUNK_WIDTH; x++) {
+    for (int y = 0; y < CHUNK_HEIGHT; y++) {
+      for (int z = 0; z < CHUNK_DEPTH; z++) {
+        snapshot->types[x][y][z] = case_block(bench, x, y, z);
+      }
+    }
+  }
+  snapshot->lod = bench->lod;
+  for (int z = 0; z < CHUNK_DEPTH; z++) {
+    snapshot->halo_x_neg[z] = case_column(bench, -1, z);
+    snapshot->halo_x_pos[z] = case_column(bench, CHUNK_WIDTH, z);
+    for (int d = 1; d < 1 << bench->lod; d++) {
+      snapshot->halo_x_neg_inner[d - 1][z] = case_column(bench, -1 - d, z);
+      snapshot->halo_x_pos_inner[d - 1][z] =
+          case_column(bench, CHUNK_WIDTH + d, z);
+    }
+  }
+  for (int x = 0; x < CHUNK_WIDTH; x++) {
+    snapshot->halo_z_neg[x] = case_column(bench, x, -1);
+    snapshot->halo_z_pos[x] = case_column(bench, x, CHUNK_DEPTH);
+    for (int d = 1; d < 1 << bench->lod; d++) {
+      snapshot->halo_z_neg_inner[d - 1][x] = case_column(bench, x, -1 - d);
+      snapshot->halo_z_pos_inner[d - 1][x] =
+          case_column(bench, x, CHUNK_DEPTH + d);
+    }
+  }
+}
+
+// Referência de força bruta, sobre células de scale blocos de lado (1 no
+// nível de detalhe 0): cada face exposta de uma célula sólida vale 1. A célula
+// é sólida quando pelo menos metade do volume dela é, dentro ou fora do chunk
+
+typedef uint8_t SurfaceGrid[6][CHUNK_WIDTH][CHUNK_HEIGHT][CHUNK_DEPTH];
+
+static const int directions[6][3] = {{1, 0, 0},  {-1, 0, 0}, {0, 1, 0},
+                                     {0, -1, 0}, {0, 0, 1},  {0, 0, -1}};
+
+static int reference_solid(const BenchCase* bench, int x, int y, int z,
+                           int scale) {
+  int solid = 0;
+  for (int i = 0; i < scale; i++) {
+    for (int j = 0; j < scale; j++) {
+      for (int k = 0; k < scale; k++) {
+        solid += case_block(bench, x * scale + i, y * scale + j,
+                            z * scale + k) != BLOCK_AIR;
+      }
+    }
+  }
+  return solid * 2 >= scale * scale * scale;
+}
+
+static void reference_surface(const BenchCase* bench, int scale,
+                              SurfaceGrid surface) {
+  memset(surface, 0, sizeof(SurfaceGrid));
+  for (int x = 0; x < CHUNK_WIDTH / scale; x++) {
+    for (int y = 0; y < CHUNK_HEIGHT / scale; y++) {
+      for (int z = 0; z < CHUNK_DEPTH / scale; z++) {
+        if (!reference_solid(bench, x, y, z, scale)) continue;
+        for (int f = 0; f < 6; f++) {
+          surface[f][x][y][z] = !reference_solid(
+              bench, x + directions[f][0], y + directions[f][1],
+              z + directions[f][2], scale);
+        }
+      }
+    }
+  }
+}
+
+// O tipo de um quad precisa ser o do bloco (nível 0) ou de algum bloco da
+// célula; qual deles a célula mostra é escolha do gerador
+static int reference_type_ok(const BenchCase* bench, int x, int y, int z,
+                             int scale, uint8_t type) {
+  if (type == BLOCK_AIR) return 0;
+  for (int i = 0; i < scale; i++) {
+    for (int j = 0; j < scale; j++) {
+      for (int k = 0; k < scale; k++) {
+        if (case_block(bench, x * scale + i, y * scale + j, z * scale + k) ==
+            type) {
+          return 1;
+        }
+      }
+    }
+  }
+  return 0;
+}
+
+// Confere as seções geradas contra a referência: cada quad, expandido em
+// faces de célula, precisa cair em faces expostas, com um tipo válido, sem
+// repetir nenhuma, e no fim todas as faces expostas precisam ter sido
+// cobertas. Também confere o agrupamento por face e os planos usados no
+// descarte do desenho. Retorna o número de erros
+static int check_mesh(const BenchCase* bench,
+                      const ChunkMesh sections[CHUNK_SECTIONS],
+                      const SurfaceGrid expected, SurfaceGrid covered) {
+  // Eixos u e v da textura para as faces de cada eixo (X, Y, Z), como em
+  // assets/shaders/vertex_pulling.glsl
+  static const int axes[3][2] = {{2, 1}, {0, 2}, {0, 1}};
+  int scale = 1 << bench->lod;
+  memset(covered, 0, sizeof(SurfaceGrid));
+  int errors = 0;
+
+  for (int s = 0; s < CHUNK_SECTIONS; s++) {
+    const ChunkMesh* mesh = &sections[s];
+    size_t q = 0;
+    for (int group = 0; group < 6; group++) {
+      int best_plane = 0, found = 0;
+      for (size_t end = q + mesh->face_quads[group]; q < end; q++) {
+        ChunkQuad quad = mesh->quads[q];
+        int origin[3] = {quad & 31, (quad >> 5) & 63, (quad >> 11) & 31};
+        int f = (quad >> 16) & 7;
+        uint8_t type = (quad >> 19) & 7;
+        int size[3] = {scale, scale, scale};
+        size[axes[f / 2][0]] = ((quad >> 22) & 31) + 1;
+        size[axes[f / 2][1]] = ((quad >> 27) & 31) + 1;
+
+        if (f != group || origin[1] / CHUNK_SECTION_HEIGHT != s) errors++;
+        // O registro guarda o bloco encostado no plano da face
+        int d = f / 2, positive = f % 2 == 0;
+        int plane = origin[d] + positive;
+        if (!found || (positive ? plane < best_plane : plane > best_plane)) {
+          best_plane = plane;
+          found = 1;
+        }
+        origin[d] = plane - positive * scale;
+
+        int cell[3], cells[3];
+        for (int a = 0; a < 3; a++) {
+          if (origin[a] % scale || size[a] % scale) errors++;
+          cell[a] = origin[a] / scale;
+          cells[a] = size[a] / scale;
+        }
+        for (int x = cell[0]; x < cell[0] + cells[0]; x++) {
+          for (int y = cell[1]; y < cell[1] + cells[1]; y++) {
+            for (int z = cell[2]; z < cell[2] + cells[2]; z++) {
+              if (x >= CHUNK_WIDTH / scale || y >= CHUNK_HEIGHT / scale ||
+                  z >= CHUNK_DEPTH / scale || covered[f][x][y][z] ||
+                  !expected[f][x][y][z] ||
+                  !reference_type_ok(bench, x, y, z, scale, type)) {
+                errors++;
+                continue;
+              }
+              covered[f][x][y][z] = 1;
+            }
+          }
+        }
+      }
+      if (found && mesh->face_plane[group] != best_plane) errors++;
+    }
+    if (q != mesh->quad_count) errors++;
+  }
+
+  if (memcmp(covered, expected, sizeof(SurfaceGrid)) != 0) errors++;
+  return errors;
+}
+
+// Confere os cubos instanciados, sempre em resolução cheia: exatamente os
+// blocos com alguma face exposta, cada um com o próprio tipo
+static int check_instances(const BenchCase* bench,
+                           const ChunkInstance* instances, size_t count,
+                           const SurfaceGrid expected) {
+  static uint8_t seen[CHUNK_WIDTH][CHUNK_HEIGHT][CHUNK_DEPTH];
+  memset(seen, 0, sizeof(seen));
+  int errors = 0;
+  for (size_t i = 0; i < count; i++) {
+    int x = instances[i] & 31, y = (instances[i] >> 5) & 63;
+    int z = (instances[i] >> 11) & 31;
+    uint8_t type = (instances[i] >> 16) & 7;
+    if (seen[x][y][z] || type != case_block(bench, x, y, z)) errors++;
+    seen[x][y][z] = 1;
+  }
+  for (int x = 0; x < CHUNK_WIDTH; x++) {
+    for (int y = 0; y < CHUNK_HEIGHT; y++) {
+      for (int z = 0; z < CHUNK_DEPTH; z++) {
+        uint8_t exposed = 0;
+        for (int f = 0; f < 6; f++) exposed |= expected[f][x][y][z];
+        if (seen[x][y][z] != exposed) errors++;
+      }
+    }
+  }
+  return errors;
+}
+
+static double now_seconds() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Resultado de uma combinação de chunk e gerador. records são os registros de
+// 4 bytes enviados à GPU: quads da malha ou cubos instanciados
+typedef struct {
+  double ns_per_voxel;
+  size_t records;
+  size_t triangles;
+  size_t bytes;
+  double allocations;
+  double cache_ns_per_voxel;  // Acréscimo do cache de malhas numa falta
+  double cache_allocations;
+  int errors;
+  int unused;  // Cubos instanciados recusados pelo gerador
+} BenchResult;
+
+// Mede mesher_build, com o cache de malhas desligado, até passar de
+// BENCH_MIN_SECONDS
+static void time_mesher(const ChunkSnapshot* snapshot, MeshMode mode,
+                        double* ns_per_voxel, double* allocations_per_run) {
+  ChunkMesh sections[CHUNK_SECTIONS] = {0};
+  size_t runs = 0;
+  size_t first_allocation = allocations;
+  double start = now_seconds(), elapsed;
+  do {
+    mesher_build(snapshot, mode, CHUNK_ALL_SECTIONS, sections);
+    for (int s = 0; s < CHUNK_SECTIONS; s++) mesher_free_mesh(&sections[s]);
+    runs++;
+    elapsed = now_seconds() - start;
+  } while (elapsed < BENCH_MIN_SECONDS);
+
+  *ns_per_voxel = elapsed * 1e9 / ((double)runs * VOXELS);
+  *allocations_per_run = (double)(allocations - first_allocation) / runs;
+}
+
+// Mede o que o cache de malhas acrescenta ao mesher_build numa falta: as
+// chaves das seções, a cópia delas para o cache e o descarte
+static void time_cache_miss(const ChunkSnapshot* snapshot, MeshMode mode,
+                            const ChunkMesh sections[CHUNK_SECTIONS],
+                            double* ns_per_voxel,
+                            double* allocations_per_run) {
+  size_t runs = 0;
+  size_t first_allocation = allocations;
+  double start = now_seconds(), elapsed;
+  do {
+    for (int s = 0; s < CHUNK_SECTIONS; s++) {
+      mesh_cache_put(mesh_cache_key(snapshot, mode, s), s, &sections[s]);
+    }
+    mesh_cache_clear();
+    runs++;
+    elapsed = now_seconds() - start;
+  } while (elapsed < BENCH_MIN_SECONDS);
+
+  *ns_per_voxel = elapsed * 1e9 / ((double)runs * VOXELS);
+  *allocations_per_run = (double)(allocations - first_allocation) / runs;
+}
+
+// Geradores de malha, medidos sem o cache de malhas; o custo que o cache
+// acrescenta numa falta sai à parte
+static BenchResult bench_mesher(const BenchCase* bench,
+                                const ChunkSnapshot* snapshot, MeshMode mode,
+                                const SurfaceGrid expected,
+                                SurfaceGrid covered) {
+  BenchResult result = {0};
+  ChunkMesh sections[CHUNK_SECTIONS] = {0};
+
+  // Primeira rodada fora da medição: aquece a área de rascunho e é a saída
+  // conferida com a referência
+  mesh_cache_set_enabled(0);
+  if (!mesher_build(snapshot, mode, CHUNK_ALL_SECTIONS, sections)) {
+    result.errors = 1;
+    return result;
+  }
+  for (int s = 0; s < CHUNK_SECTIONS; s++) {
+    result.records += sections[s].quad_count;
+  }
+  result.triangles = result.records * 2;
+  result.bytes = result.records * sizeof(ChunkQuad);
+  result.errors = check_mesh(bench, sections, expected, covered);
+
+  time_mesher(snapshot, mode, &result.ns_per_voxel, &result.allocations);
+  time_cache_miss(snapshot, mode, sections, &result.cache_ns_per_voxel,
+                  &result.cache_allocations);
+  for (int s = 0; s < CHUNK_SECTIONS; s++) mesher_free_mesh(&sections[s]);
+  mesh_cache_set_enabled(1);
+  return result;
+}
+
+// Cubos instanciados no lugar da malha do modo dado. Os registros e
+// triângulos saem da referência mesmo quando o gerador recusa os cubos, para
+// comparar os dois caminhos; o tempo é o da decisão (e da lista, se aceita)
+static BenchResult bench_instances(const BenchCase* bench,
+                                   const ChunkSnapshot* snapshot,
+                                   MeshMode mode, const SurfaceGrid expected) {
+  BenchResult result = {0};
+  for (int x = 0; x < CHUNK_WIDTH; x++) {
+    for (int y = 0; y < CHUNK_HEIGHT; y++) {
+      for (int z = 0; z < CHUNK_DEPTH; z++) {
+        uint8_t exposed = 0;
+        for (int f = 0; f < 6; f++) exposed |= expected[f][x][y][z];
+        result.records += exposed;
+      }
+    }
+  }
+  result.triangles = result.records * 12;
+  result.bytes = result.records * sizeof(ChunkInstance);
+
+  ChunkInstance* instances;
+  size_t count;
+  if (mesher_build_instances(snapshot, mode, &instances, &count)) {
+    result.errors = check_instances(bench, instances, count, expected);
+    free(instances);
+  } else {
+    result.unused = 1;
+  }
+
+  size_t runs = 0;
+  size_t first_allocation = allocations;
+  double start = now_seconds(), elapsed;
+  do {
+    if (mesher_build_instances(snapshot, mode, &instances, &count)) {
+      free(instances);
+    }
+    runs++;
+    elapsed = now_seconds() - start;
+  } while (elapsed < BENCH_MIN_SECONDS);
+
+  result.ns_per_voxel = elapsed * 1e9 / ((double)runs * VOXELS);
+  result.allocations = (double)(allocations - first_allocation) / runs;
+  return result;
+}
+
+static void print_result(const BenchCase* bench, const char* mesher,
+                         const BenchResult* result) {
+  const char* status = result->errors ? "FALHOU" : "ok";
+  if (result->unused) status = "não usado";
+  printf("%-13s %3d %-8s %-12s %9.2f %9zu %9zu %9zu %7.1f %8.2f %7.1f  %s\n",
+         bench->name, bench->lod, bench->neighbors ? "com" : "sem", mesher,
+         result->ns_per_voxel, result->records, result->triangles,
+         result->bytes, result->allocations, result->cache_ns_per_voxel,
+         result->cache_allocations, status);
+}
+
+int main() {
+  static ChunkSnapshot snapshot;
+  static SurfaceGrid expected, covered;
+  static const struct {
+    const char* name;
+    MeshMode mode;
+  } meshers[] = {{"faces", MESH_MODE_FACES}, {"greedy", MESH_MODE_GREEDY}};
+
+  static const struct {
+    const char* name;
+    MeshMode mode;
+  } instanced[] = {{"cubos/faces", MESH_MODE_FACES},
+                   {"cubos/greedy", MESH_MODE_GREEDY}};
+
+  printf("%-13s %3s %-8s %-12s %9s %9s %9s %9s %7s %8s %7s  %s\n", "chunk",
+         "lod", "vizinhos", "gerador", "ns/voxel", "registros", "tris",
+         "bytes", "allocs", "+cache", "+allocs", "referência");
+
+  int failures = 0;
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    const BenchCase* bench = &cases[i];
+    build_snapshot(bench, &snapshot);
+
+    reference_surface(bench, 1 << bench->lod, expected);
+    for (size_t m = 0; m < sizeof(meshers) / sizeof(meshers[0]); m++) {
+      BenchResult result =
+          bench_mesher(bench, &snapshot, meshers[m].mode, expected, covered);
+      print_result(bench, meshers[m].name, &result);
+      failures += result.errors != 0;
+    }
+
+    // Os cubos instanciados ignoram o nível de detalhe; só os chunks com
+    // poucos blocos expostos entram na comparação
+    reference_surface(bench, 1, expected);
+    for (size_t m = 0; m < sizeof(instanced) / sizeof(instanced[0]); m++) {
+      BenchResult result =
+          bench_instances(bench, &snapshot, instanced[m].mode, expected);
+      if (result.records == 0 || result.records > BENCH_MAX_INSTANCES) break;
+      print_result(bench, instanced[m].name, &result);
+      failures += result.errors != 0;
+    }
+  }
+
+  mesher_free_scratch();
+  mesh_cache_clear();
+  if (failures) {
+    fprintf(stderr, "%d combinações diferem da referência\n", failures);
+    return 1;
+  }
+  return 0;
+}
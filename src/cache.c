@@ -0,0 +1,97 @@
+// src/cache.c
+
+#include "cache.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Hash FNV-1a de 64 bits. Encadeável: passe o resultado anterior como seed
+uint64_t cache_hash(const void* data, size_t size, uint64_t seed) {
+  const unsigned char* bytes = (const unsigned char*)data;
+  uint64_t hash = seed;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+// Hash de palavras de 64 bits, bem mais rápido que cache_hash em blocos
+// grandes. Encadeável como cache_hash; size precisa ser múltiplo de 8
+uint64_t cache_hash_words(const void* data, size_t size, uint64_t seed) {
+  const unsigned char* bytes = (const unsigned char*)data;
+  uint64_t hash = seed;
+  for (size_t i = 0; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, bytes + i, sizeof(word));
+    hash = (hash ^ word) * 0x9e3779b97f4a7c15ULL;
+    hash ^= hash >> 29;
+  }
+  return hash;
+}
+
+// Mistura o tamanho e a data de modificação de um arquivo no hash. Serve para
+// invalidar um cache quando o arquivo de origem muda, sem precisar lê-lo
+uint64_t cache_hash_file_stamp(const char* filename, uint64_t seed) {
+  struct stat st;
+  if (stat(filename, &st) != 0) {
+    return cache_hash(filename, 0, seed ^ 0xffULL);
+  }
+  int64_t stamp[2] = {(int64_t)st.st_size, (int64_t)st.st_mtime};
+  return cache_hash(stamp, sizeof(stamp), seed);
+}
+
+// Mapeia um arquivo de cache inteiro em memória (somente leitura)
+void* cache_map(const char* filename, size_t* out_size) {
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0) return NULL;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    return NULL;
+  }
+
+  void* data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) return NULL;
+
+  *out_size = st.st_size;
+  return data;
+}
+
+void cache_unmap(void* data, size_t size) {
+  if (data) munmap(data, size);
+}
+
+// Grava o arquivo de cache de forma atômica: escreve num temporário e renomeia,
+// para que uma execução interrompida nunca deixe um cache pela metade
+int cache_write(const char* filename, const void* data, size_t size) {
+  if (mkdir(CACHE_DIR, 0755) != 0 && errno != EEXIST) {
+    fprintf(stderr, "Não foi possível criar o diretório %s\n", CACHE_DIR);
+    return 0;
+  }
+
+  char temp_name[512];
+  snprintf(temp_name, sizeof(temp_name), "%s.tmp", filename);
+
+  FILE* file = fopen(temp_name, "wb");
+  if (!file) {
+    fprintf(stderr, "Não foi possível criar o arquivo %s\n", temp_name);
+    return 0;
+  }
+  size_t written = fwrite(data, 1, size, file);
+  fclose(file);
+
+  if (written != size || rename(temp_name, filename) != 0) {
+    fprintf(stderr, "Falha ao gravar o cache %s\n", filename);
+    remove(temp_name);
+    return 0;
+  }
+  return 1;
+}
@@ -0,0 +1,21 @@
+// src/cache.h
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Diretório dos arquivos de cache gerados em tempo de execução
+#define CACHE_DIR "assets/cache"
+
+#define CACHE_HASH_SEED 0xcbf29ce484222325ULL
+
+uint64_t cache_hash(const void* data, size_t size, uint64_t seed);
+uint64_t cache_hash_words(const void* data, size_t size, uint64_t seed);
+uint64_t cache_hash_file_stamp(const char* filename, uint64_t seed);
+void* cache_map(const char* filename, size_t* out_size);
+void cache_unmap(void* data, size_t size);
+int cache_write(const char* filename, const void* data, size_t size);
+
+#endif  // CACHE_H
@@ -3,8 +3,70 @@
 #include "chunk.h"
 
 #include <GL/glew.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include "mesher.h"
+#include "world.h"
+
+// Quads endereçáveis com índices de 16 bits (65536 vértices). Malhas maiores
+// são desenhadas em lotes desse tamanho, deslocando o vértice base
+#define QUAD_BATCH (65536 / 4)
+
+// Folga reservada na faixa de cada seção no VBO, para que edições pequenas
+// caibam sem realocar o buffer inteiro
+#define SECTION_SLACK(quads) ((quads) / 4 + 16)
+
+// Índices (0, 1, 2, 0, 2, 3) + 4 * quad, iguais para todas as malhas. Um único
+// buffer atende todos os chunks
+static GLuint quad_indices;
+
+// Caminho de renderização com vertex pulling (GL 4.3): a GPU recebe só os
+// registros de quad, sem expandir em vértices
+static int vertex_pulling = 0;
+
+void chunk_set_vertex_pulling(int enabled) { vertex_pulling = enabled; }
+
+// Cubo unitário do renderer (24 vértices de posição e textura, 36 índices),
+// compartilhado pelos chunks desenhados com instâncias
+static GLuint cube_vbo, cube_ebo;
+
+void chunk_set_instance_cube(GLuint vbo, GLuint ebo) {
+  cube_vbo = vbo;
+  cube_ebo = ebo;
+}
+
+void chunk_init_quad_indices() {
+  uint16_t* indices = malloc(QUAD_BATCH * 6 * sizeof(uint16_t));
+  if (!indices) {
+    fprintf(stderr, "Erro: Falha ao alocar memória para os índices.\n");
+    return;
+  }
+  for (int q = 0; q < QUAD_BATCH; q++) {
+    uint16_t base = (uint16_t)(q * 4);
+    indices[q * 6 + 0] = base;
+    indices[q * 6 + 1] = base + 1;
+    indices[q * 6 + 2] = base + 2;
+    indices[q * 6 + 3] = base;
+    indices[q * 6 + 4] = base + 2;
+    indices[q * 6 + 5] = base + 3;
+  }
+
+  glGenBuffers(1, &quad_indices);
+  // Sem VAO ligado, o upload passa pelo alvo GL_ARRAY_BUFFER
+  glBindBuffer(GL_ARRAY_BUFFER, quad_indices);
+  glBufferData(GL_ARRAY_BUFFER, QUAD_BATCH * 6 * sizeof(uint16_t), indices,
+               GL_STATIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  free(indices);
+}
+
+void chunk_cleanup_quad_indices() {
+  glDeleteBuffers(1, &quad_indices);
+  quad_indices = 0;
+}
 
 Chunk* chunk_create(int x, int z) {
   Chunk* chunk = (Chunk*)malloc(sizeof(Chunk));
@@ -31,10 +93,16 @@ Chunk* chunk_create(int x, int z) {
   // **Adicione esta parte para gerar os buffers**
   glGenVertexArrays(1, &chunk->vao);
   glGenBuffers(1, &chunk->vbo);
-  glGenBuffers(1, &chunk->ebo);
 
-  chunk->index_count = 0;
-  chunk->needs_update = 1;  // Marcar como precisando de atualização inicial
+  chunk->quad_count = 0;
+  chunk->instanced = 0;
+  chunk->instance_count = 0;
+  chunk->gpu_meshed = 0;
+  memset(chunk->section_capacity, 0, sizeof(chunk->section_capacity));
+  chunk->needs_update = CHUNK_ALL_SECTIONS;  // Todas as seções na primeira vez
+  chunk->mesh_pending = 0;
+  chunk->lod = 0;
+  memset(chunk->sections, 0, sizeof(chunk->sections));
 
   return chunk;
 }
@@ -43,8 +111,10 @@ void chunk_destroy(Chunk* chunk) {
   // Limpa os buffers do OpenGL
   glDeleteVertexArrays(1, &chunk->vao);
   glDeleteBuffers(1, &chunk->vbo);
-  glDeleteBuffers(1, &chunk->ebo);
 
+  for (int s = 0; s < CHUNK_SECTIONS; s++) {
+    mesher_free_mesh(&chunk->sections[s]);
+  }
   free(chunk);
 }
 
@@ -56,95 +126,427 @@ Block* chunk_get_block(Chunk* chunk, int x, int y, int z) {
   return NULL;
 }
 
-void chunk_update_mesh(Chunk* chunk) {
-  typedef struct {
-    float position[3];
-    float tex_coords[2];
-    int block_type;
-  } Vertex;
-
-  size_t max_blocks = CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_DEPTH;
-  size_t max_faces = max_blocks * 6;
-  size_t max_vertices = max_faces * 4;
-  size_t max_indices = max_faces * 6;
-
-  Vertex* vertices = malloc(max_vertices * sizeof(Vertex));
-  unsigned int* indices = malloc(max_indices * sizeof(unsigned int));
-  if (!vertices || !indices) {
-    fprintf(stderr, "Erro: Falha ao alocar memória para mesh.\n");
-    free(vertices);
-    free(indices);
-    return;
+static MeshMode mesh_mode = MESH_MODE_GREEDY;
+
+void chunk_set_mesh_mode(MeshMode mode) { mesh_mode = mode; }
+
+MeshMode chunk_get_mesh_mode() { return mesh_mode; }
+
+// Máscara de solidez de uma coluna (bit y ligado quando o bloco é sólido)
+static uint64_t column_mask(Chunk* chunk, int x, int z) {
+  uint64_t mask = 0;
+  for (int y = 0; y < CHUNK_HEIGHT; y++) {
+    mask |= (uint64_t)(chunk->blocks[x][y][z].type != BLOCK_AIR) << y;
   }
+  return mask;
+}
 
-  size_t vertex_count = 0, index_count = 0;
+// Borda de um vizinho como o chunk a enxerga. Um vizinho em outro nível de
+// detalhe conta como ar: o chunk fecha a borda com as próprias paredes, que
+// cobrem os degraus entre as superfícies de resoluções diferentes
+static Chunk* halo_neighbor(Chunk* chunk, int x, int z) {
+  Chunk* neighbor = world_get_chunk(x, z);
+  return neighbor && neighbor->lod == chunk->lod ? neighbor : NULL;
+}
 
+// Copia o estado atual do chunk e a borda de um voxel dos vizinhos, para que a
+// malha possa ser gerada fora da thread principal sem ver edições pela metade.
+// Sem vizinho, a borda fica vazia (ar) e as paredes do mundo aparecem.
+void chunk_snapshot(Chunk* chunk, ChunkSnapshot* snapshot) {
   for (int x = 0; x < CHUNK_WIDTH; x++) {
     for (int y = 0; y < CHUNK_HEIGHT; y++) {
       for (int z = 0; z < CHUNK_DEPTH; z++) {
-        Block* block = &chunk->blocks[x][y][z];
-        if (block->type == BLOCK_AIR) continue;
-
-        // Para cada face, você verifica se precisa ser renderizada e adiciona
-        // os vértices e índices Face frontal (Z+)
-        if (z == CHUNK_DEPTH - 1 ||
-            chunk->blocks[x][y][z + 1].type == BLOCK_AIR) {
-          Vertex v1 = {{x, y, z + 1}, {0.0f, 0.0f}, block->type};
-          Vertex v2 = {{x + 1, y, z + 1}, {1.0f, 0.0f}, block->type};
-          Vertex v3 = {{x + 1, y + 1, z + 1}, {1.0f, 1.0f}, block->type};
-          Vertex v4 = {{x, y + 1, z + 1}, {0.0f, 1.0f}, block->type};
-
-          vertices[vertex_count++] = v1;
-          vertices[vertex_count++] = v2;
-          vertices[vertex_count++] = v3;
-          vertices[vertex_count++] = v4;
-
-          unsigned int base_index = vertex_count - 4;
-          indices[index_count++] = base_index;
-          indices[index_count++] = base_index + 1;
-          indices[index_count++] = base_index + 2;
-          indices[index_count++] = base_index;
-          indices[index_count++] = base_index + 2;
-          indices[index_count++] = base_index + 3;
-        }
+        snapshot->types[x][y][z] = (uint8_t)chunk->blocks[x][y][z].type;
+      }
+    }
+  }
 
-        // Repita o mesmo para as outras faces...
+  snapshot->lod = chunk->lod;
 
-        // Verifique se não ultrapassou a capacidade
-        if (vertex_count + 4 > max_vertices || index_count + 6 > max_indices) {
-          fprintf(
-              stderr,
-              "Erro: Excedeu a capacidade máxima de vértices ou índices.\n");
-          free(vertices);
-          free(indices);
-          return;
-        }
+  Chunk* x_neg = halo_neighbor(chunk, chunk->x - 1, chunk->z);
+  Chunk* x_pos = halo_neighbor(chunk, chunk->x + 1, chunk->z);
+  Chunk* z_neg = halo_neighbor(chunk, chunk->x, chunk->z - 1);
+  Chunk* z_pos = halo_neighbor(chunk, chunk->x, chunk->z + 1);
+  for (int z = 0; z < CHUNK_DEPTH; z++) {
+    snapshot->halo_x_neg[z] =
+        x_neg ? column_mask(x_neg, CHUNK_WIDTH - 1, z) : 0;
+    snapshot->halo_x_pos[z] = x_pos ? column_mask(x_pos, 0, z) : 0;
+  }
+  for (int x = 0; x < CHUNK_WIDTH; x++) {
+    snapshot->halo_z_neg[x] =
+        z_neg ? column_mask(z_neg, x, CHUNK_DEPTH - 1) : 0;
+    snapshot->halo_z_pos[x] = z_pos ? column_mask(z_pos, x, 0) : 0;
+  }
+
+  // Nos níveis de detalhe, o resto da espessura da célula da borda, para a
+  // solidez da célula vizinha sair da mesma regra que o vizinho usa
+  memset(snapshot->halo_x_neg_inner, 0, sizeof(snapshot->halo_x_neg_inner));
+  memset(snapshot->halo_x_pos_inner, 0, sizeof(snapshot->halo_x_pos_inner));
+  memset(snapshot->halo_z_neg_inner, 0, sizeof(snapshot->halo_z_neg_inner));
+  memset(snapshot->halo_z_pos_inner, 0, sizeof(snapshot->halo_z_pos_inner));
+  for (int d = 1; d < 1 << chunk->lod; d++) {
+    for (int z = 0; z < CHUNK_DEPTH; z++) {
+      if (x_neg) {
+        snapshot->halo_x_neg_inner[d - 1][z] =
+            column_mask(x_neg, CHUNK_WIDTH - 1 - d, z);
+      }
+      if (x_pos) {
+        snapshot->halo_x_pos_inner[d - 1][z] = column_mask(x_pos, d, z);
+      }
+    }
+    for (int x = 0; x < CHUNK_WIDTH; x++) {
+      if (z_neg) {
+        snapshot->halo_z_neg_inner[d - 1][x] =
+            column_mask(z_neg, x, CHUNK_DEPTH - 1 - d);
+      }
+      if (z_pos) {
+        snapshot->halo_z_pos_inner[d - 1][x] = column_mask(z_pos, x, d);
       }
     }
   }
+}
+
+// Marca para refazer a seção que contém a camada y. Se a célula da camada
+// (1 << lod blocos de altura) encosta numa fronteira entre seções, a face entre
+// as duas células pertence à seção vizinha, que também é marcada
+void chunk_mark_dirty(Chunk* chunk, int y) {
+  int section = y / CHUNK_SECTION_HEIGHT;
+  int cell = 1 << chunk->lod;
+  chunk->needs_update |= 1u << section;
+  if (y % CHUNK_SECTION_HEIGHT < cell && section > 0) {
+    chunk->needs_update |= 1u << (section - 1);
+  }
+  if (y % CHUNK_SECTION_HEIGHT >= CHUNK_SECTION_HEIGHT - cell &&
+      section < CHUNK_SECTIONS - 1) {
+    chunk->needs_update |= 1u << (section + 1);
+  }
+}
+
+// Troca o nível de detalhe do chunk. A malha inteira dele é refeita, e também
+// a dos quatro vizinhos, cujas bordas dependem de estarem no mesmo nível
+void chunk_set_lod(Chunk* chunk, int lod) {
+  if (lod == chunk->lod) return;
+  chunk->lod = lod;
+  chunk->needs_update = CHUNK_ALL_SECTIONS;
+
+  static const int offsets[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+  for (int i = 0; i < 4; i++) {
+    Chunk* neighbor =
+        world_get_chunk(chunk->x + offsets[i][0], chunk->z + offsets[i][1]);
+    if (neighbor) neighbor->needs_update = CHUNK_ALL_SECTIONS;
+  }
+}
+
+// Bytes ocupados por quads no VBO: registros crus no vertex pulling, quatro
+// vértices por quad no caminho clássico
+static size_t quad_bytes(size_t quads) {
+  return vertex_pulling ? quads * sizeof(ChunkQuad)
+                        : quads * 4 * sizeof(ChunkVertex);
+}
+
+// Escreve os quads da seção em dest, já no formato do VBO
+static void write_section(const ChunkMesh* section, void* dest) {
+  if (vertex_pulling) {
+    memcpy(dest, section->quads, section->quad_count * sizeof(ChunkQuad));
+  } else {
+    mesher_expand_quads(section->quads, section->quad_count, dest);
+  }
+}
+
+// Mapeia os quads [first, first + count) do VBO ligado e escreve neles as
+// seções indicadas, cada uma no início da sua faixa. Retorna 0 se o conteúdo
+// não chegou à GPU
+static int write_sections(Chunk* chunk, unsigned sections, size_t first,
+                          size_t count, GLbitfield invalidate) {
+  char* dest = glMapBufferRange(GL_ARRAY_BUFFER, quad_bytes(first),
+                                quad_bytes(count),
+                                GL_MAP_WRITE_BIT | invalidate);
+  if (!dest) return 0;
+  for (int s = 0; s < CHUNK_SECTIONS; s++) {
+    if ((sections & (1u << s)) && chunk->sections[s].quad_count > 0) {
+      write_section(&chunk->sections[s],
+                    dest + quad_bytes(chunk->section_first[s] - first));
+    }
+  }
+  // GL_FALSE indica que o conteúdo se perdeu durante o mapeamento
+  return glUnmapBuffer(GL_ARRAY_BUFFER) == GL_TRUE;
+}
+
+// Realoca o VBO com faixas novas para todas as seções, com folga para
+// crescerem, e refaz o VAO para a malha. Retorna a capacidade em quads; o
+// conteúdo do buffer fica indefinido. VBO do chunk ligado em GL_ARRAY_BUFFER
+static size_t realloc_sections(Chunk* chunk) {
+  size_t capacity = 0;
+  for (int s = 0; s < CHUNK_SECTIONS; s++) {
+    size_t count = chunk->sections[s].quad_count;
+    chunk->section_first[s] = capacity;
+    chunk->section_capacity[s] = count + SECTION_SLACK(count);
+    capacity += chunk->section_capacity[s];
+  }
 
-  // Upload para a GPU
   glBindVertexArray(chunk->vao);
+  glBufferData(GL_ARRAY_BUFFER, quad_bytes(capacity), NULL, GL_STATIC_DRAW);
+  if (vertex_pulling) {
+    // O shader lê os registros direto do buffer, ligado como storage buffer
+    // no desenho
+    glDisableVertexAttribArray(0);
+  } else {
+    glVertexAttribIPointer(0, 2, GL_UNSIGNED_INT, sizeof(ChunkVertex),
+                           (void*)0);
+    glEnableVertexAttribArray(0);
+  }
+  // Atributos do modo instanciado, caso o chunk tenha passado por ele
+  glDisableVertexAttribArray(1);
+  glDisableVertexAttribArray(2);
+  // O VAO guarda o buffer de índices; todos apontam para o compartilhado
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quad_indices);
+  glBindVertexArray(0);
+
+  chunk->instanced = 0;
+  chunk->instance_count = 0;
+  return capacity;
+}
+
+// Seções que a próxima geração de malha precisa refazer. Sem a cópia das
+// seções na CPU (chunk instanciado ou com a malha gerada na GPU), qualquer
+// atualização refaz todas
+unsigned chunk_pending_sections(const Chunk* chunk) {
+  if (chunk->instanced || chunk->gpu_meshed) return CHUNK_ALL_SECTIONS;
+  return chunk->needs_update;
+}
+
+// Substitui as seções indicadas pelas malhas novas (o chunk assume os
+// buffers) e envia para a GPU. Cada seção tem uma faixa fixa no VBO com folga;
+// se todas as seções novas couberem nas suas faixas, só elas são reescritas.
+// Caso contrário o buffer é realocado com faixas novas. Retorna os bytes
+// enviados. Só pode rodar na thread do OpenGL
+size_t chunk_upload_mesh(Chunk* chunk, unsigned sections, ChunkMesh* meshes) {
+  size_t quad_count = 0;
+  // Vindo do modo instanciado ou da GPU, o VAO e as faixas são refeitos
+  int fits = !chunk->instanced && !chunk->gpu_meshed;
+  chunk->gpu_meshed = 0;
+  for (int s = 0; s < CHUNK_SECTIONS; s++) {
+    if (sections & (1u << s)) {
+      mesher_free_mesh(&chunk->sections[s]);
+      chunk->sections[s] = meshes[s];
+      memset(&meshes[s], 0, sizeof(ChunkMesh));
+      if (chunk->sections[s].quad_count > (size_t)chunk->section_capacity[s]) {
+        fits = 0;
+      }
+    }
+    quad_count += chunk->sections[s].quad_count;
+  }
+
   glBindBuffer(GL_ARRAY_BUFFER, chunk->vbo);
-  glBufferData(GL_ARRAY_BUFFER, vertex_count * sizeof(Vertex), vertices,
-               GL_STATIC_DRAW);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, chunk->ebo);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_count * sizeof(unsigned int),
-               indices, GL_STATIC_DRAW);
+  size_t bytes = 0;
+  int ok = 1;
+  if (fits) {
+    // Cada seção é mapeada só na sua faixa, que a GPU pode descartar
+    for (int s = 0; s < CHUNK_SECTIONS && ok; s++) {
+      size_t count = chunk->sections[s].quad_count;
+      if (!(sections & (1u << s)) || count == 0) continue;
+      ok = write_sections(chunk, 1u << s, chunk->section_first[s], count,
+                          GL_MAP_INVALIDATE_RANGE_BIT);
+      bytes += quad_bytes(count);
+    }
+  } else {
+    size_t capacity = realloc_sections(chunk);
+    ok = write_sections(chunk, CHUNK_ALL_SECTIONS, 0, capacity,
+                        GL_MAP_INVALIDATE_BUFFER_BIT);
+    bytes = quad_bytes(quad_count);
+  }
+
+  if (!ok) {
+    // Fica sem malha até a próxima atualização, que realoca e reenvia tudo
+    fprintf(stderr, "Erro: Falha ao enviar a mesh do chunk (%d, %d).\n",
+            chunk->x, chunk->z);
+    memset(chunk->section_capacity, 0, sizeof(chunk->section_capacity));
+    chunk->quad_count = 0;
+    chunk->needs_update = CHUNK_ALL_SECTIONS;
+    return 0;
+  }
+  chunk->quad_count = quad_count;
+  return bytes;
+}
 
-  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                        (void*)offsetof(Vertex, position));
+// Prepara o VBO para uma malha gerada na GPU: as seções passam a ser as
+// indicadas, só com as contagens e os planos (sem quads na CPU), e o buffer é
+// realocado com a faixa de cada uma. Quem chama escreve os quads nas faixas
+// (ver section_first). Só pode rodar na thread do OpenGL
+void chunk_reserve_mesh(Chunk* chunk, const ChunkMesh layout[CHUNK_SECTIONS]) {
+  size_t quad_count = 0;
+  for (int s = 0; s < CHUNK_SECTIONS; s++) {
+    mesher_free_mesh(&chunk->sections[s]);
+    chunk->sections[s] = layout[s];
+    chunk->sections[s].quads = NULL;
+    quad_count += layout[s].quad_count;
+  }
+
+  glBindBuffer(GL_ARRAY_BUFFER, chunk->vbo);
+  realloc_sections(chunk);
+  chunk->gpu_meshed = 1;
+  chunk->quad_count = quad_count;
+}
+
+// Troca a malha do chunk por cubos instanciados, um por bloco exposto. As
+// seções na CPU são descartadas; se o chunk voltar a ter malha, todas são
+// geradas de novo. Retorna os bytes enviados. Só pode rodar na thread do
+// OpenGL
+size_t chunk_upload_instances(Chunk* chunk, const ChunkInstance* instances,
+                              size_t count) {
+  for (int s = 0; s < CHUNK_SECTIONS; s++) {
+    mesher_free_mesh(&chunk->sections[s]);
+    memset(&chunk->sections[s], 0, sizeof(ChunkMesh));
+  }
+  memset(chunk->section_capacity, 0, sizeof(chunk->section_capacity));
+  chunk->quad_count = 0;
+  chunk->gpu_meshed = 0;
+
+  size_t bytes = count * sizeof(ChunkInstance);
+  glBindVertexArray(chunk->vao);
+
+  // Posição e textura vêm do cubo compartilhado, por vértice
+  glBindBuffer(GL_ARRAY_BUFFER, cube_vbo);
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float),
+                        (void*)0);
   glEnableVertexAttribArray(0);
-  glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                        (void*)offsetof(Vertex, tex_coords));
+  glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float),
+                        (void*)(3 * sizeof(float)));
   glEnableVertexAttribArray(1);
 
+  // O bloco vem do VBO do chunk, um registro por instância
+  glBindBuffer(GL_ARRAY_BUFFER, chunk->vbo);
+  glBufferData(GL_ARRAY_BUFFER, bytes, instances, GL_STATIC_DRAW);
+  glVertexAttribIPointer(2, 1, GL_UNSIGNED_INT, sizeof(ChunkInstance),
+                         (void*)0);
+  glVertexAttribDivisor(2, 1);
+  glEnableVertexAttribArray(2);
+
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cube_ebo);
   glBindVertexArray(0);
 
-  chunk->index_count = index_count;
+  chunk->instanced = 1;
+  chunk->instance_count = count;
+  return bytes;
+}
 
-  free(vertices);
-  free(indices);
+// Faixas de quads acumuladas para um só glMultiDrawElementsBaseVertex. O
+// buffer de índices só cobre QUAD_BATCH quads, então faixas maiores viram
+// vários lotes com vértice base deslocado
+#define DRAW_RANGES 64
+
+typedef struct {
+  GLsizei counts[DRAW_RANGES];
+  const void* offsets[DRAW_RANGES];
+  GLint base_vertices[DRAW_RANGES];
+  int range_count;
+  int first, count;  // Faixa aberta, que ainda pode crescer
+} DrawList;
 
-  chunk->needs_update = 0;
+static void draw_list_submit(DrawList* list) {
+  if (list->range_count == 0) return;
+  glMultiDrawElementsBaseVertex(GL_TRIANGLES, list->counts, GL_UNSIGNED_SHORT,
+                                list->offsets, list->range_count,
+                                list->base_vertices);
+  list->range_count = 0;
+}
+
+// Fecha a faixa aberta, quebrando-a em lotes
+static void draw_list_close(DrawList* list) {
+  for (int done = 0; done < list->count; done += QUAD_BATCH) {
+    int batch = list->count - done;
+    if (batch > QUAD_BATCH) batch = QUAD_BATCH;
+    if (list->range_count == DRAW_RANGES) draw_list_submit(list);
+    list->counts[list->range_count] = batch * 6;
+    list->offsets[list->range_count] = (void*)0;
+    list->base_vertices[list->range_count] = (list->first + done) * 4;
+    list->range_count++;
+  }
+  list->count = 0;
+}
+
+// Acrescenta os quads [first, first + count), emendando com a faixa aberta
+// quando são contíguos
+static void draw_list_add(DrawList* list, int first, int count) {
+  if (list->count > 0 && list->first + list->count == first) {
+    list->count += count;
+    return;
+  }
+  draw_list_close(list);
+  list->first = first;
+  list->count = count;
+}
+
+// Desenha o chunk visto do ponto eye (coordenadas do mundo). Um grupo de faces
+// de uma seção só aparece se o olho estiver do lado para onde aponta a normal
+// de pelo menos um dos planos; os grupos de costas são pulados inteiros. O
+// resto sai numa só chamada de desenho
+void chunk_draw(Chunk* chunk, const float eye[3]) {
+  float local[3] = {eye[0] - chunk->x * CHUNK_WIDTH, eye[1],
+                    eye[2] - chunk->z * CHUNK_DEPTH};
+
+  glBindVertexArray(chunk->vao);
+  if (vertex_pulling) {
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, chunk->vbo);
+  }
+  DrawList list;
+  list.range_count = 0;
+  list.count = 0;
+  for (int s = 0; s < CHUNK_SECTIONS; s++) {
+    const ChunkMesh* section = &chunk->sections[s];
+    int first = chunk->section_first[s];
+    for (int f = 0; f < 6; f++) {
+      int count = section->face_quads[f];
+      // Faces pares apontam para o lado positivo do eixo f / 2
+      float position = local[f / 2];
+      if (count > 0 && (f % 2 == 0 ? position > section->face_plane[f]
+                                   : position < section->face_plane[f])) {
+        draw_list_add(&list, first, count);
+      }
+      first += count;
+    }
+  }
+  draw_list_close(&list);
+  draw_list_submit(&list);
+  glBindVertexArray(0);
+}
+
+// Desenha um chunk do modo instanciado: o cubo inteiro de cada bloco exposto
+void chunk_draw_instances(Chunk* chunk) {
+  glBindVertexArray(chunk->vao);
+  glDrawElementsInstanced(GL_TRIANGLES, 36, GL_UNSIGNED_INT, (void*)0,
+                          chunk->instance_count);
+  glBindVertexArray(0);
+}
+
+// Gera e envia na hora, na thread atual (sem o pool de trabalho), as seções
+// marcadas como desatualizadas
+void chunk_update_mesh(Chunk* chunk) {
+  ChunkSnapshot* snapshot = malloc(sizeof(ChunkSnapshot));
+  if (!snapshot) {
+    fprintf(stderr, "Erro: Falha ao alocar memória para mesh.\n");
+    return;
+  }
+  chunk_snapshot(chunk, snapshot);
+
+  ChunkInstance* instances;
+  size_t instance_count;
+  if (mesher_build_instances(snapshot, mesh_mode, &instances,
+                             &instance_count)) {
+    free(snapshot);
+    chunk->needs_update = 0;
+    chunk_upload_instances(chunk, instances, instance_count);
+    free(instances);
+    return;
+  }
+
+  unsigned sections = chunk_pending_sections(chunk);
+  ChunkMesh meshes[CHUNK_SECTIONS] = {0};
+  int ok = mesher_build(snapshot, mesh_mode, sections, meshes);
+  free(snapshot);
+  if (ok) {
+    chunk->needs_update = 0;
+    chunk_upload_mesh(chunk, sections, meshes);
+  }
+  for (int s = 0; s < CHUNK_SECTIONS; s++) mesher_free_mesh(&meshes[s]);
 }
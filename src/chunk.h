@@ -4,6 +4,8 @@
 #define CHUNK_H
 
 #include <GL/glew.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #include "block.h"
 
@@ -11,17 +13,119 @@
 #define CHUNK_HEIGHT 64
 #define CHUNK_DEPTH 32
 
+// A malha de cada chunk é dividida em seções de 16 blocos de altura, para que
+// uma edição refaça só as seções afetadas
+#define CHUNK_SECTION_HEIGHT 16
+#define CHUNK_SECTIONS (CHUNK_HEIGHT / CHUNK_SECTION_HEIGHT)
+#define CHUNK_ALL_SECTIONS ((1u << CHUNK_SECTIONS) - 1)
+#define CHUNK_SECTION_MASK ((1ULL << CHUNK_SECTION_HEIGHT) - 1)
+
+// Níveis de detalhe: no nível n a malha é gerada sobre células de 2^n blocos
+// de lado (1, 2 e 4)
+#define CHUNK_LOD_LEVELS 3
+// Lado da maior célula, e quantas colunas da borda dos vizinhos ela cobre
+#define CHUNK_HALO_DEPTH (1 << (CHUNK_LOD_LEVELS - 1))
+
+// Algoritmo usado para gerar a malha dos chunks
+typedef enum {
+  MESH_MODE_FACES,  // Um quad por face exposta
+  MESH_MODE_GREEDY  // Faces coplanares do mesmo tipo fundidas em retângulos
+} MeshMode;
+
+// Vértice compactado em duas palavras de 32 bits (8 bytes). O layout precisa
+// bater com a decodificação em assets/shaders/vertex_shader.glsl:
+//   position: x (6 bits) | y (7) << 6 | z (6) << 13 | face (3) << 19 |
+//             canto do quad (2) << 22
+//   material: tipo do bloco (8 bits) | largura (7) << 8 | altura (7) << 15
+// x, y e z são os cantos locais ao chunk (0..32, 0..64, 0..32); largura e
+// altura são a extensão do quad em blocos ao longo de u e v da textura.
+typedef struct {
+  uint32_t position;
+  uint32_t material;
+} ChunkVertex;
+
+// Registro de um quad numa palavra de 32 bits. O layout precisa bater com a
+// decodificação em assets/shaders/vertex_pulling.glsl:
+//   x (5 bits) | y (6) << 5 | z (5) << 11 | face (3) << 16 | tipo (3) << 19 |
+//   largura - 1 (5) << 22 | altura - 1 (5) << 27
+// (x, y, z) é o bloco encostado no plano da face; largura e altura são a
+// extensão em blocos ao longo de u e v da textura, e a espessura é sempre 1.
+// O caminho com atributos de vértice expande cada registro em 4 ChunkVertex.
+typedef uint32_t ChunkQuad;
+
+// Instância do cubo unitário, usada nos chunks esparsos no lugar da malha: um
+// registro de 32 bits por bloco exposto. O layout precisa bater com a
+// decodificação em assets/shaders/instanced_cube.glsl:
+//   x (5 bits) | y (6) << 5 | z (5) << 11 | tipo (3) << 16
+typedef uint32_t ChunkInstance;
+
+// Malha de um chunk na CPU, pronta para upload: um registro por quad. Os
+// índices vêm do buffer de quads compartilhado. Os quads ficam agrupados por
+// face, na ordem X+, X-, Y+, Y-, Z+, Z-; face_plane guarda o plano (local, ao
+// longo da normal) mais próximo do lado de onde o grupo é visível: o menor
+// para as faces positivas, o maior para as negativas
+typedef struct {
+  ChunkQuad* quads;
+  size_t quad_count;
+  size_t face_quads[6];
+  int face_plane[6];
+} ChunkMesh;
+
 typedef struct {
   int x, z;
   Block blocks[CHUNK_WIDTH][CHUNK_HEIGHT][CHUNK_DEPTH];
-  int needs_update;      // Flag para indicar se o chunk precisa ser atualizado
-  GLuint vao, vbo, ebo;  // Buffers de renderização
-  int index_count;       // Número de índices para desenhar
+  unsigned needs_update;  // Bits das seções cuja malha precisa ser refeita
+  int mesh_pending;       // Malha sendo gerada no pool de trabalho
+  int lod;                // Nível de detalhe da malha
+  GLuint vao, vbo;        // Buffers de renderização
+  int quad_count;         // Número de quads para desenhar
+  int instanced;          // Desenhado como cubos instanciados, sem malha
+  int instance_count;     // Blocos desenhados no modo instanciado
+  int gpu_meshed;         // Malha gerada na GPU (seções sem cópia na CPU)
+  int section_first[CHUNK_SECTIONS];     // Início da faixa de cada seção no VBO
+  int section_capacity[CHUNK_SECTIONS];  // Quads que cabem em cada faixa
+  ChunkMesh sections[CHUNK_SECTIONS];  // Cópia na CPU da malha de cada seção
 } Chunk;
 
+// Cópia consistente de tudo o que a geração de malha lê de um chunk: os tipos
+// dos blocos e, dos quatro vizinhos, só a coluna de solidez encostada na borda
+// (uma borda de um voxel). Pode ser processada em qualquer thread.
+typedef struct {
+  uint8_t types[CHUNK_WIDTH][CHUNK_HEIGHT][CHUNK_DEPTH];
+  uint64_t halo_x_neg[CHUNK_DEPTH];  // Vizinho X-, coluna x = CHUNK_WIDTH - 1
+  uint64_t halo_x_pos[CHUNK_DEPTH];  // Vizinho X+, coluna x = 0
+  uint64_t halo_z_neg[CHUNK_WIDTH];  // Vizinho Z-, coluna z = CHUNK_DEPTH - 1
+  uint64_t halo_z_pos[CHUNK_WIDTH];  // Vizinho Z+, coluna z = 0
+  int lod;                           // Nível de detalhe da malha
+  // Nos níveis de detalhe a célula da borda tem 1 << lod colunas de
+  // espessura: aqui ficam as colunas seguintes de cada vizinho, indo para
+  // dentro dele (inner[d - 1] a d colunas da borda). Só as primeiras
+  // (1 << lod) - 1 são preenchidas; as demais ficam zeradas
+  uint64_t halo_x_neg_inner[CHUNK_HALO_DEPTH - 1][CHUNK_DEPTH];
+  uint64_t halo_x_pos_inner[CHUNK_HALO_DEPTH - 1][CHUNK_DEPTH];
+  uint64_t halo_z_neg_inner[CHUNK_HALO_DEPTH - 1][CHUNK_WIDTH];
+  uint64_t halo_z_pos_inner[CHUNK_HALO_DEPTH - 1][CHUNK_WIDTH];
+} ChunkSnapshot;
+
+void chunk_init_quad_indices();
+void chunk_cleanup_quad_indices();
+void chunk_set_vertex_pulling(int enabled);
+void chunk_set_instance_cube(GLuint vbo, GLuint ebo);
 Chunk* chunk_create(int x, int z);
 void chunk_destroy(Chunk* chunk);
 Block* chunk_get_block(Chunk* chunk, int x, int y, int z);
 void chunk_update_mesh(Chunk* chunk);
+void chunk_set_mesh_mode(MeshMode mode);
+MeshMode chunk_get_mesh_mode();
+void chunk_snapshot(Chunk* chunk, ChunkSnapshot* snapshot);
+size_t chunk_upload_mesh(Chunk* chunk, unsigned sections, ChunkMesh* meshes);
+void chunk_reserve_mesh(Chunk* chunk, const ChunkMesh layout[CHUNK_SECTIONS]);
+unsigned chunk_pending_sections(const Chunk* chunk);
+size_t chunk_upload_instances(Chunk* chunk, const ChunkInstance* instances,
+                              size_t count);
+void chunk_mark_dirty(Chunk* chunk, int y);
+void chunk_set_lod(Chunk* chunk, int lod);
+void chunk_draw(Chunk* chunk, const float eye[3]);
+void chunk_draw_instances(Chunk* chunk);
 
 #endif  // CHUNK_H
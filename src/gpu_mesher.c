@@ -0,0 +1,160 @@
+// src/gpu_mesher.c
+//
+// Geração de malha na GPU (opcional, GL 4.3, só com vertex pulling). A thread
+// do OpenGL envia os blocos do chunk para um storage buffer e roda o compute
+// shader de assets/shaders/mesher_compute.glsl em duas passadas: a primeira
+// conta as faces de cada grupo (seção, face), o que dá o tamanho exato de cada
+// faixa do VBO; a segunda escreve os quads direto nas faixas. Na CPU fica só o
+// snapshot e a leitura de 24 contadores. Gera um quad por face exposta (como
+// MESH_MODE_FACES) e só nos chunks de detalhe máximo; os demais continuam no
+// pool de trabalho.
+
+#include "gpu_mesher.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mesher.h"
+
+// O shader conta com 4 seções de 16 camadas num chunk de 32 x 64 x 32
+_Static_assert(CHUNK_WIDTH == 32 && CHUNK_HEIGHT == 64 && CHUNK_DEPTH == 32 &&
+                   CHUNK_SECTIONS == 4,
+               "mesher_compute.glsl assume chunks de 32 x 64 x 32");
+
+#define GROUP_SIZE 8  // local_size do shader em cada eixo
+#define GROUPS (CHUNK_SECTIONS * 6)
+
+// Bloco Groups do shader
+typedef struct {
+  uint32_t counts[GROUPS];
+  int32_t planes[GROUPS];
+  uint32_t cursors[GROUPS];
+} GpuMeshGroups;
+
+static int enabled = 0;
+static GLuint program;
+static GLint emit_quads_location;
+static GLuint blocks_buffer;  // Tipos e bordas do chunk sendo gerado
+static GLuint groups_buffer;  // GpuMeshGroups
+
+// Pedido do usuário (--gpu-mesher); só vale se o programa compilar
+void gpu_mesher_set_enabled(int value) { enabled = value; }
+
+int gpu_mesher_enabled() { return enabled; }
+
+// Assume o programa do compute shader (0 desliga a geração na GPU)
+void gpu_mesher_init(GLuint compute_program) {
+  program = compute_program;
+  if (!program) return;
+  emit_quads_location = glGetUniformLocation(program, "emitQuads");
+
+  glGenBuffers(1, &blocks_buffer);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, blocks_buffer);
+  glBufferData(GL_SHADER_STORAGE_BUFFER, offsetof(ChunkSnapshot, lod), NULL,
+               GL_STREAM_DRAW);
+
+  glGenBuffers(1, &groups_buffer);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, groups_buffer);
+  glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(GpuMeshGroups), NULL,
+               GL_DYNAMIC_READ);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void gpu_mesher_cleanup() {
+  if (!program) return;
+  glDeleteBuffers(1, &blocks_buffer);
+  glDeleteBuffers(1, &groups_buffer);
+  glDeleteProgram(program);
+  program = 0;
+}
+
+int gpu_mesher_active() { return enabled && program != 0; }
+
+// Gera na GPU a malha do chunk inteiro e deixa o chunk pronto para desenho.
+// Chunks esparsos continuam virando cubos instanciados. Retorna os bytes
+// escritos no VBO. Só pode rodar na thread do OpenGL
+size_t gpu_mesher_build(Chunk* chunk) {
+  ChunkSnapshot* snapshot = malloc(sizeof(ChunkSnapshot));
+  if (!snapshot) {
+    fprintf(stderr, "Erro: Falha ao alocar memória para mesh.\n");
+    return 0;
+  }
+  chunk_snapshot(chunk, snapshot);
+  chunk->needs_update = 0;
+
+  ChunkInstance* instances;
+  size_t instance_count;
+  // A malha da GPU tem um quad por face exposta, como MESH_MODE_FACES
+  if (mesher_build_instances(snapshot, MESH_MODE_FACES, &instances,
+                             &instance_count)) {
+    free(snapshot);
+    size_t bytes = chunk_upload_instances(chunk, instances, instance_count);
+    free(instances);
+    return bytes;
+  }
+
+  // Tipos e bordas são o começo do snapshot, no layout do bloco Blocks
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, blocks_buffer);
+  glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, offsetof(ChunkSnapshot, lod),
+                  snapshot);
+  free(snapshot);
+
+  GpuMeshGroups groups;
+  memset(&groups, 0, sizeof(groups));
+  for (int g = 0; g < GROUPS; g++) {
+    groups.planes[g] = g % 2 == 0 ? CHUNK_HEIGHT + 1 : -1;
+  }
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, groups_buffer);
+  glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(groups), &groups);
+
+  GLint previous_program;
+  glGetIntegerv(GL_CURRENT_PROGRAM, &previous_program);
+  glUseProgram(program);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, blocks_buffer);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, groups_buffer);
+
+  // Primeira passada: contagens e planos de cada grupo
+  glUniform1i(emit_quads_location, 0);
+  glDispatchCompute(CHUNK_WIDTH / GROUP_SIZE, CHUNK_HEIGHT / GROUP_SIZE,
+                    CHUNK_DEPTH / GROUP_SIZE);
+  glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+  glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0,
+                     offsetof(GpuMeshGroups, cursors), &groups);
+
+  ChunkMesh layout[CHUNK_SECTIONS];
+  memset(layout, 0, sizeof(layout));
+  for (int s = 0; s < CHUNK_SECTIONS; s++) {
+    for (int f = 0; f < 6; f++) {
+      layout[s].face_quads[f] = groups.counts[s * 6 + f];
+      layout[s].face_plane[f] = groups.planes[s * 6 + f];
+      layout[s].quad_count += layout[s].face_quads[f];
+    }
+  }
+  chunk_reserve_mesh(chunk, layout);
+
+  // Segunda passada: cada grupo escreve a partir do início da sua faixa
+  if (chunk->quad_count > 0) {
+    for (int s = 0; s < CHUNK_SECTIONS; s++) {
+      uint32_t first = chunk->section_first[s];
+      for (int f = 0; f < 6; f++) {
+        groups.cursors[s * 6 + f] = first;
+        first += groups.counts[s * 6 + f];
+      }
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, groups_buffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, offsetof(GpuMeshGroups, cursors),
+                    sizeof(groups.cursors), groups.cursors);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, chunk->vbo);
+    glUniform1i(emit_quads_location, 1);
+    glDispatchCompute(CHUNK_WIDTH / GROUP_SIZE, CHUNK_HEIGHT / GROUP_SIZE,
+                      CHUNK_DEPTH / GROUP_SIZE);
+    // O desenho lê os quads como storage buffer no vertex shader
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+  }
+
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+  glUseProgram(previous_program);
+  return chunk->quad_count * sizeof(ChunkQuad);
+}
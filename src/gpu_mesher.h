@@ -0,0 +1,18 @@
+// src/gpu_mesher.h
+
+#ifndef GPU_MESHER_H
+#define GPU_MESHER_H
+
+#include <GL/glew.h>
+#include <stddef.h>
+
+#include "chunk.h"
+
+void gpu_mesher_set_enabled(int enabled);
+int gpu_mesher_enabled();
+void gpu_mesher_init(GLuint program);
+void gpu_mesher_cleanup();
+int gpu_mesher_active();
+size_t gpu_mesher_build(Chunk* chunk);
+
+#endif  // GPU_MESHER_H
@@ -4,8 +4,11 @@
 #include <GLFW/glfw3.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "camera.h"
+#include "gpu_mesher.h"
+#include "mesh_worker.h"
 #include "player.h"
 #include "renderer.h"
 #include "world.h"
@@ -47,20 +50,44 @@ void window_focus_callback(GLFWwindow* window, int focused) {
   }
 }
 
-int main() {
+int main(int argc, char** argv) {
+  // --gpu-mesher: gera as malhas num compute shader (requer OpenGL 4.3)
+  // --upload-budget=KB,MS: bytes e tempo por quadro para enviar malhas à GPU
+  for (int i = 1; i < argc; i++) {
+    size_t budget_kb;
+    double budget_ms;
+    if (strcmp(argv[i], "--gpu-mesher") == 0) {
+      gpu_mesher_set_enabled(1);
+    } else if (strncmp(argv[i], "--upload-budget=", 16) == 0) {
+      if (sscanf(argv[i] + 16, "%zu,%lf", &budget_kb, &budget_ms) == 2 &&
+          budget_kb > 0 && budget_ms > 0.0) {
+        mesh_worker_set_upload_budget(budget_kb * 1024, budget_ms);
+      } else {
+        fprintf(stderr, "Erro: Orçamento inválido: %s\n", argv[i]);
+      }
+    } else {
+      fprintf(stderr, "Opção desconhecida: %s\n", argv[i]);
+    }
+  }
+
   // Inicializa o GLFW
   if (!glfwInit()) {
     fprintf(stderr, "Falha ao inicializar o GLFW\n");
     return -1;
   }
 
-  // Configura o contexto OpenGL
-  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+  // Configura o contexto OpenGL: tenta 4.3 (vertex pulling) e cai para 3.3
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
   glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
   glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
   // Cria a janela
   GLFWwindow* window = glfwCreateWindow(800, 600, "Voxel Viewer", NULL, NULL);
+  if (!window) {
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    window = glfwCreateWindow(800, 600, "Voxel Viewer", NULL, NULL);
+  }
   if (!window) {
     fprintf(stderr, "Falha ao criar a janela GLFW\n");
     glfwTerminate();
@@ -92,6 +119,7 @@ int main() {
   // Inicializa sistemas
   renderer_init();
   world_init();
+  mesh_worker_init();
   camera_init();
   player_init();
 
@@ -119,6 +147,7 @@ int main() {
 
   // Limpa e finaliza
   camera_cleanup();
+  mesh_worker_cleanup();
   world_cleanup();
   renderer_cleanup();
 
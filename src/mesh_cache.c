@@ -0,0 +1,283 @@
+// src/mesh_cache.c
+//
+// Cache LRU das malhas de seção na CPU, indexado por um hash do que cada seção
+// lê do chunk (blocos, bordas dos vizinhos, nível de detalhe e modo de malha).
+// Um chunk que volta a um estado já visto (um bloco quebrado e recolocado, um
+// chunk recarregado sem mudanças) reaproveita a malha sem gerá-la de novo.
+// Usado pelas threads de trabalho, por isso tudo passa por um mutex.
+//
+// Entre execuções o cache fica em disco (MESH_CACHE_FILE), e os chunks que não
+// mudaram desde a última sessão não precisam ser gerados antes do primeiro
+// quadro. Layout do arquivo (ordem de bytes nativa):
+//   MeshCacheHeader
+//   para cada entrada, da menos para a mais usada: MeshCacheRecord seguido
+//   de quad_count registros ChunkQuad
+
+#include "mesh_cache.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cache.h"
+#include "mesher.h"
+
+#define MESH_CACHE_MAGIC 0x434d5856  // "VXMC"
+// Aumente quando o formato de ChunkQuad ou a saída do gerador de malha mudar
+#define MESH_CACHE_VERSION 3
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t entry_count;
+  uint32_t reserved;
+} MeshCacheHeader;
+
+typedef struct {
+  uint64_t key;
+  uint32_t section;
+  uint32_t quad_count;
+  uint32_t face_quads[6];
+  int32_t face_plane[6];
+} MeshCacheRecord;
+
+typedef struct {
+  uint64_t key;
+  int section;
+  uint64_t last_used;  // Tique do último acesso; 0 = entrada livre
+  ChunkMesh mesh;
+} MeshCacheEntry;
+
+static MeshCacheEntry entries[MESH_CACHE_ENTRIES];
+static uint64_t tick = 0;
+static unsigned long hits = 0, misses = 0;
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Desligado, mesher_build nem calcula a chave (usado pelo benchmark do gerador)
+static int enabled = 1;
+
+void mesh_cache_set_enabled(int value) { enabled = value; }
+
+int mesh_cache_enabled() { return enabled; }
+
+// Soma ao hash as camadas rows de uma borda de vizinho
+static uint64_t hash_halo(const uint64_t* halo, int count, uint64_t rows,
+                          uint64_t hash) {
+  uint64_t masked[CHUNK_WIDTH > CHUNK_DEPTH ? CHUNK_WIDTH : CHUNK_DEPTH];
+  for (int i = 0; i < count; i++) masked[i] = halo[i] & rows;
+  return cache_hash_words(masked, count * sizeof(masked[0]), hash);
+}
+
+// Hash de tudo o que a geração de malha da seção lê do snapshot: as camadas
+// de blocos dela mais uma camada de células acima e abaixo (a visibilidade na
+// fronteira depende delas), e as mesmas camadas das bordas dos vizinhos. Uma
+// edição só muda a chave das seções que a enxergam
+uint64_t mesh_cache_key(const ChunkSnapshot* snapshot, MeshMode mode,
+                        int section) {
+  int scale = 1 << snapshot->lod;
+  int y0 = section * CHUNK_SECTION_HEIGHT - scale;
+  int y1 = (section + 1) * CHUNK_SECTION_HEIGHT + scale;
+  if (y0 < 0) y0 = 0;
+  if (y1 > CHUNK_HEIGHT) y1 = CHUNK_HEIGHT;
+  uint64_t rows = ((1ULL << (y1 - y0)) - 1) << y0;
+
+  uint64_t header[3] = {(uint64_t)section, (uint64_t)snapshot->lod,
+                        (uint64_t)mode};
+  uint64_t hash = cache_hash_words(header, sizeof(header), CACHE_HASH_SEED);
+  size_t slab = (size_t)(y1 - y0) * CHUNK_DEPTH;
+  for (int x = 0; x < CHUNK_WIDTH; x++) {
+    hash = cache_hash_words(snapshot->types[x][y0], slab, hash);
+  }
+  hash = hash_halo(snapshot->halo_x_neg, CHUNK_DEPTH, rows, hash);
+  hash = hash_halo(snapshot->halo_x_pos, CHUNK_DEPTH, rows, hash);
+  hash = hash_halo(snapshot->halo_z_neg, CHUNK_WIDTH, rows, hash);
+  hash = hash_halo(snapshot->halo_z_pos, CHUNK_WIDTH, rows, hash);
+  for (int d = 0; d < scale - 1; d++) {
+    hash = hash_halo(snapshot->halo_x_neg_inner[d], CHUNK_DEPTH, rows, hash);
+    hash = hash_halo(snapshot->halo_x_pos_inner[d], CHUNK_DEPTH, rows, hash);
+    hash = hash_halo(snapshot->halo_z_neg_inner[d], CHUNK_WIDTH, rows, hash);
+    hash = hash_halo(snapshot->halo_z_pos_inner[d], CHUNK_WIDTH, rows, hash);
+  }
+  return hash;
+}
+
+// Cópia com buffers próprios; a original continua com quem a passou
+static int mesh_clone(const ChunkMesh* mesh, ChunkMesh* out_mesh) {
+  *out_mesh = *mesh;
+  out_mesh->quads = NULL;
+  if (mesh->quad_count == 0) return 1;
+
+  size_t bytes = mesh->quad_count * sizeof(ChunkQuad);
+  out_mesh->quads = malloc(bytes);
+  if (!out_mesh->quads) {
+    out_mesh->quad_count = 0;
+    return 0;
+  }
+  memcpy(out_mesh->quads, mesh->quads, bytes);
+  return 1;
+}
+
+// Procura a malha da seção; num acerto, out_mesh recebe uma cópia que deve
+// ser liberada com mesher_free_mesh
+int mesh_cache_get(uint64_t key, int section, ChunkMesh* out_mesh) {
+  pthread_mutex_lock(&cache_lock);
+  int found = 0;
+  for (int i = 0; i < MESH_CACHE_ENTRIES; i++) {
+    MeshCacheEntry* entry = &entries[i];
+    if (entry->last_used && entry->key == key && entry->section == section) {
+      entry->last_used = ++tick;
+      found = mesh_clone(&entry->mesh, out_mesh);
+      break;
+    }
+  }
+  if (found) {
+    hits++;
+  } else {
+    misses++;
+  }
+  pthread_mutex_unlock(&cache_lock);
+  return found;
+}
+
+// Guarda uma cópia da malha, no lugar da entrada usada há mais tempo
+void mesh_cache_put(uint64_t key, int section, const ChunkMesh* mesh) {
+  pthread_mutex_lock(&cache_lock);
+  MeshCacheEntry* victim = &entries[0];
+  for (int i = 0; i < MESH_CACHE_ENTRIES; i++) {
+    MeshCacheEntry* entry = &entries[i];
+    if (entry->last_used && entry->key == key && entry->section == section) {
+      victim = entry;  // Outra thread já guardou esta seção
+      break;
+    }
+    if (entry->last_used < victim->last_used) victim = entry;
+  }
+
+  mesher_free_mesh(&victim->mesh);
+  if (mesh_clone(mesh, &victim->mesh)) {
+    victim->key = key;
+    victim->section = section;
+    victim->last_used = ++tick;
+  } else {
+    victim->last_used = 0;
+  }
+  pthread_mutex_unlock(&cache_lock);
+}
+
+void mesh_cache_report() {
+  pthread_mutex_lock(&cache_lock);
+  unsigned long total = hits + misses;
+  printf("Cache de malhas: %lu acertos, %lu faltas (%.1f%% de acerto)\n",
+         hits, misses, total ? 100.0 * hits / total : 0.0);
+  pthread_mutex_unlock(&cache_lock);
+}
+
+// Libera todas as entradas e zera as estatísticas
+void mesh_cache_clear() {
+  pthread_mutex_lock(&cache_lock);
+  for (int i = 0; i < MESH_CACHE_ENTRIES; i++) {
+    mesher_free_mesh(&entries[i].mesh);
+    entries[i].last_used = 0;
+  }
+  tick = 0;
+  hits = misses = 0;
+  pthread_mutex_unlock(&cache_lock);
+}
+
+static int compare_last_used(const void* a, const void* b) {
+  const MeshCacheEntry* x = *(const MeshCacheEntry* const*)a;
+  const MeshCacheEntry* y = *(const MeshCacheEntry* const*)b;
+  return (x->last_used > y->last_used) - (x->last_used < y->last_used);
+}
+
+// Grava as entradas em uso no arquivo de cache, da menos para a mais usada
+void mesh_cache_save() {
+  pthread_mutex_lock(&cache_lock);
+  MeshCacheEntry* used[MESH_CACHE_ENTRIES];
+  int count = 0;
+  size_t size = sizeof(MeshCacheHeader);
+  for (int i = 0; i < MESH_CACHE_ENTRIES; i++) {
+    if (!entries[i].last_used) continue;
+    used[count++] = &entries[i];
+    size += sizeof(MeshCacheRecord) +
+            entries[i].mesh.quad_count * sizeof(ChunkQuad);
+  }
+  qsort(used, count, sizeof(used[0]), compare_last_used);
+
+  unsigned char* data = malloc(size);
+  if (!data) {
+    pthread_mutex_unlock(&cache_lock);
+    return;
+  }
+  MeshCacheHeader header = {MESH_CACHE_MAGIC, MESH_CACHE_VERSION,
+                            (uint32_t)count, 0};
+  memcpy(data, &header, sizeof(header));
+  size_t offset = sizeof(header);
+  for (int i = 0; i < count; i++) {
+    const ChunkMesh* mesh = &used[i]->mesh;
+    MeshCacheRecord record = {used[i]->key, (uint32_t)used[i]->section,
+                              (uint32_t)mesh->quad_count, {0}, {0}};
+    for (int f = 0; f < 6; f++) {
+      record.face_quads[f] = (uint32_t)mesh->face_quads[f];
+      record.face_plane[f] = mesh->face_plane[f];
+    }
+    memcpy(data + offset, &record, sizeof(record));
+    offset += sizeof(record);
+    if (mesh->quad_count > 0) {
+      memcpy(data + offset, mesh->quads, mesh->quad_count * sizeof(ChunkQuad));
+      offset += mesh->quad_count * sizeof(ChunkQuad);
+    }
+  }
+  pthread_mutex_unlock(&cache_lock);
+
+  cache_write(MESH_CACHE_FILE, data, size);
+  free(data);
+}
+
+// Carrega as entradas gravadas por mesh_cache_save. Um arquivo de outra
+// versão, truncado ou inconsistente é ignorado a partir do primeiro registro
+// inválido
+void mesh_cache_load() {
+  size_t size;
+  unsigned char* data = cache_map(MESH_CACHE_FILE, &size);
+  if (!data) return;
+
+  MeshCacheHeader header;
+  if (size < sizeof(header)) {
+    cache_unmap(data, size);
+    return;
+  }
+  memcpy(&header, data, sizeof(header));
+  if (header.magic != MESH_CACHE_MAGIC ||
+      header.version != MESH_CACHE_VERSION) {
+    cache_unmap(data, size);
+    return;
+  }
+
+  size_t offset = sizeof(header);
+  for (uint32_t i = 0; i < header.entry_count; i++) {
+    MeshCacheRecord record;
+    if (size - offset < sizeof(record)) break;
+    memcpy(&record, data + offset, sizeof(record));
+    offset += sizeof(record);
+
+    size_t quad_bytes = (size_t)record.quad_count * sizeof(ChunkQuad);
+    size_t face_total = 0;
+    for (int f = 0; f < 6; f++) face_total += record.face_quads[f];
+    if (record.section >= CHUNK_SECTIONS || face_total != record.quad_count ||
+        size - offset < quad_bytes) {
+      break;
+    }
+
+    ChunkMesh mesh = {0};
+    mesh.quads = (ChunkQuad*)(data + offset);
+    mesh.quad_count = record.quad_count;
+    for (int f = 0; f < 6; f++) {
+      mesh.face_quads[f] = record.face_quads[f];
+      mesh.face_plane[f] = record.face_plane[f];
+    }
+    mesh_cache_put(record.key, (int)record.section, &mesh);
+    offset += quad_bytes;
+  }
+  cache_unmap(data, size);
+}
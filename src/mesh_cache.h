@@ -0,0 +1,27 @@
+// src/mesh_cache.h
+
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <stdint.h>
+
+#include "cache.h"
+#include "chunk.h"
+
+// Número de malhas de seção guardadas antes de descartar as menos usadas
+#define MESH_CACHE_ENTRIES 512
+
+#define MESH_CACHE_FILE CACHE_DIR "/meshes.bin"
+
+void mesh_cache_set_enabled(int enabled);
+int mesh_cache_enabled();
+uint64_t mesh_cache_key(const ChunkSnapshot* snapshot, MeshMode mode,
+                        int section);
+int mesh_cache_get(uint64_t key, int section, ChunkMesh* out_mesh);
+void mesh_cache_put(uint64_t key, int section, const ChunkMesh* mesh);
+void mesh_cache_report();
+void mesh_cache_clear();
+void mesh_cache_save();
+void mesh_cache_load();
+
+#endif  // MESH_CACHE_H
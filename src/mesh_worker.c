@@ -0,0 +1,265 @@
+// src/mesh_worker.c
+//
+// Pool de threads que gera as malhas dos chunks fora da thread do OpenGL.
+// A thread principal tira um snapshot do chunk (com a borda dos vizinhos) e o
+// coloca na fila; as threads de trabalho geram a malha das seções marcadas (ou
+// a lista de cubos, se o chunk for esparso) e devolvem os buffers, que a
+// thread principal só precisa enviar para a GPU. Com a geração na GPU, os
+// jobs vão direto para a fila de upload e a malha sai de lá.
+// As duas filas são ordenadas por prioridade (menor primeiro), e o envio para
+// a GPU respeita um orçamento de bytes e de tempo por quadro.
+
+#include "mesh_worker.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "gpu_mesher.h"
+#include "mesher.h"
+
+typedef struct MeshJob {
+  Chunk* chunk;
+  MeshMode mode;
+  float priority;     // Menor sai primeiro
+  unsigned sections;  // Seções a refazer (bits)
+  ChunkSnapshot snapshot;
+  ChunkMesh meshes[CHUNK_SECTIONS];  // Preenchidas pela thread de trabalho
+  ChunkInstance* instances;  // Chunk esparso: cubos no lugar da malha
+  size_t instance_count;
+  int instanced;
+  int ok;
+  int gpu;  // Malha gerada na GPU na hora do upload, sem snapshot nem thread
+  struct MeshJob* next;
+} MeshJob;
+
+typedef struct {
+  MeshJob* head;
+  MeshJob* tail;
+} MeshJobQueue;
+
+static pthread_t threads[MESH_WORKER_MAX_THREADS];
+static int thread_count = 0;
+
+static pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t job_available = PTHREAD_COND_INITIALIZER;
+static MeshJobQueue pending;   // Aguardando uma thread
+static MeshJobQueue finished;  // Prontos para upload
+static int shutting_down = 0;
+
+static size_t upload_budget_bytes = MESH_UPLOAD_BUDGET_BYTES;
+static double upload_budget_ms = MESH_UPLOAD_BUDGET_MS;
+
+// Insere mantendo a fila ordenada por prioridade; empates ficam na ordem de
+// chegada. As filas têm no máximo algumas centenas de jobs
+static void queue_push(MeshJobQueue* queue, MeshJob* job) {
+  MeshJob** link = &queue->head;
+  while (*link && (*link)->priority <= job->priority) link = &(*link)->next;
+  job->next = *link;
+  *link = job;
+  if (!job->next) queue->tail = job;
+}
+
+static MeshJob* queue_pop(MeshJobQueue* queue) {
+  MeshJob* job = queue->head;
+  if (job) {
+    queue->head = job->next;
+    if (!queue->head) queue->tail = NULL;
+  }
+  return job;
+}
+
+static void job_free(MeshJob* job) {
+  for (int s = 0; s < CHUNK_SECTIONS; s++) mesher_free_mesh(&job->meshes[s]);
+  free(job->instances);
+  free(job);
+}
+
+static void* worker_main(void* arg) {
+  (void)arg;
+
+  pthread_mutex_lock(&queue_lock);
+  while (1) {
+    while (!pending.head && !shutting_down) {
+      pthread_cond_wait(&job_available, &queue_lock);
+    }
+    if (shutting_down) break;
+
+    MeshJob* job = queue_pop(&pending);
+    pthread_mutex_unlock(&queue_lock);
+
+    job->instanced = mesher_build_instances(&job->snapshot, job->mode,
+                                            &job->instances,
+                                            &job->instance_count);
+    job->ok = job->instanced || mesher_build(&job->snapshot, job->mode,
+                                             job->sections, job->meshes);
+
+    pthread_mutex_lock(&queue_lock);
+    queue_push(&finished, job);
+  }
+  pthread_mutex_unlock(&queue_lock);
+
+  mesher_free_scratch();
+  return NULL;
+}
+
+void mesh_worker_init() {
+  // Deixa um núcleo livre para a thread do OpenGL
+  long cores = sysconf(_SC_NPROCESSORS_ONLN);
+  int count = cores > 1 ? (int)cores - 1 : 1;
+  if (count > MESH_WORKER_MAX_THREADS) count = MESH_WORKER_MAX_THREADS;
+
+  shutting_down = 0;
+  for (thread_count = 0; thread_count < count; thread_count++) {
+    if (pthread_create(&threads[thread_count], NULL, worker_main, NULL) != 0) {
+      fprintf(stderr, "Falha ao criar thread de geração de malha\n");
+      break;
+    }
+  }
+}
+
+void mesh_worker_cleanup() {
+  pthread_mutex_lock(&queue_lock);
+  shutting_down = 1;
+  pthread_cond_broadcast(&job_available);
+  pthread_mutex_unlock(&queue_lock);
+
+  for (int i = 0; i < thread_count; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  thread_count = 0;
+
+  // Descarta o que não chegou a ser processado ou enviado
+  MeshJob* job;
+  while ((job = queue_pop(&pending))) {
+    job->chunk->mesh_pending = 0;
+    job_free(job);
+  }
+  while ((job = queue_pop(&finished))) {
+    job->chunk->mesh_pending = 0;
+    job_free(job);
+  }
+}
+
+// Agenda a geração da malha do chunk; priority menor é atendida antes. O
+// snapshot é tirado agora, na thread principal; edições feitas depois voltam
+// a marcar o chunk com needs_update. Sem threads de trabalho, a malha é gerada
+// na hora.
+void mesh_worker_submit(Chunk* chunk, float priority) {
+  int gpu = gpu_mesher_active() && chunk->lod == 0;
+  if (thread_count == 0 && !gpu) {
+    chunk_update_mesh(chunk);
+    return;
+  }
+
+  MeshJob* job = calloc(1, sizeof(MeshJob));
+  if (!job) {
+    fprintf(stderr, "Erro: Falha ao alocar memória para mesh.\n");
+    return;
+  }
+  job->chunk = chunk;
+
+  // Com a geração na GPU, os chunks de detalhe máximo vão direto para a fila
+  // de upload: a malha é gerada lá, na thread do OpenGL, dentro do orçamento
+  // do quadro. O snapshot é tirado só nessa hora, e needs_update fica ligado
+  // até lá
+  if (gpu) {
+    job->gpu = 1;
+    job->priority = priority;
+    chunk->mesh_pending = 1;
+    pthread_mutex_lock(&queue_lock);
+    queue_push(&finished, job);
+    pthread_mutex_unlock(&queue_lock);
+    return;
+  }
+
+  job->mode = chunk_get_mesh_mode();
+  job->priority = priority;
+  job->sections = chunk_pending_sections(chunk);
+  chunk_snapshot(chunk, &job->snapshot);
+
+  chunk->needs_update = 0;
+  chunk->mesh_pending = 1;
+
+  pthread_mutex_lock(&queue_lock);
+  queue_push(&pending, job);
+  pthread_cond_signal(&job_available);
+  pthread_mutex_unlock(&queue_lock);
+}
+
+// Recalcula a prioridade de tudo o que está nas filas e as reordena. Chamado
+// uma vez por quadro, para que jobs agendados antes de o jogador virar ou
+// andar sigam a visão e a posição atuais. Thread do OpenGL
+static void queue_reprioritize(MeshJobQueue* queue, MeshPriorityFn priority,
+                               void* context) {
+  MeshJob* job = queue->head;
+  queue->head = queue->tail = NULL;
+  while (job) {
+    MeshJob* next = job->next;
+    job->priority = priority(job->chunk, context);
+    queue_push(queue, job);
+    job = next;
+  }
+}
+
+void mesh_worker_reprioritize(MeshPriorityFn priority, void* context) {
+  pthread_mutex_lock(&queue_lock);
+  queue_reprioritize(&pending, priority, context);
+  queue_reprioritize(&finished, priority, context);
+  pthread_mutex_unlock(&queue_lock);
+}
+
+void mesh_worker_set_upload_budget(size_t bytes, double milliseconds) {
+  upload_budget_bytes = bytes;
+  upload_budget_ms = milliseconds;
+}
+
+static double elapsed_ms(const struct timespec* start) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - start->tv_sec) * 1000.0 +
+         (now.tv_nsec - start->tv_nsec) / 1000000.0;
+}
+
+// Envia para a GPU as malhas prontas, das mais prioritárias para as menos,
+// até estourar o orçamento de bytes ou de tempo do quadro. Thread do OpenGL
+void mesh_worker_upload_finished() {
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  size_t uploaded = 0;
+  while (1) {
+    pthread_mutex_lock(&queue_lock);
+    MeshJob* job = queue_pop(&finished);
+    pthread_mutex_unlock(&queue_lock);
+    if (!job) break;
+
+    if (job->gpu) {
+      // O renderer pode ter perdido o compute shader num reset, ou o chunk
+      // mudado de nível de detalhe; needs_update continua ligado e o chunk
+      // volta a ser agendado pelo caminho da CPU
+      if (gpu_mesher_active() && job->chunk->lod == 0) {
+        uploaded += gpu_mesher_build(job->chunk);
+      }
+    } else if (job->ok && job->instanced) {
+      uploaded += chunk_upload_instances(job->chunk, job->instances,
+                                         job->instance_count);
+    } else if (job->ok) {
+      uploaded += chunk_upload_mesh(job->chunk, job->sections, job->meshes);
+    } else {
+      fprintf(stderr, "Erro: Falha ao gerar a malha do chunk (%d, %d)\n",
+              job->chunk->x, job->chunk->z);
+      // Volta a marcar as seções, para tentar de novo num próximo quadro
+      job->chunk->needs_update |= job->sections;
+    }
+    job->chunk->mesh_pending = 0;
+    job_free(job);
+
+    if (uploaded >= upload_budget_bytes ||
+        elapsed_ms(&start) >= upload_budget_ms) {
+      break;
+    }
+  }
+}
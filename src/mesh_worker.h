@@ -0,0 +1,25 @@
+// src/mesh_worker.h
+
+#ifndef MESH_WORKER_H
+#define MESH_WORKER_H
+
+#include "chunk.h"
+
+#define MESH_WORKER_MAX_THREADS 16
+
+// Orçamento padrão, por quadro, para enviar malhas prontas à GPU. O que não
+// couber fica para os próximos quadros (pelo menos um chunk sai por quadro)
+#define MESH_UPLOAD_BUDGET_BYTES (1024 * 1024)
+#define MESH_UPLOAD_BUDGET_MS 2.0
+
+// Prioridade de um chunk na fila (menor primeiro), recalculada a cada quadro
+typedef float (*MeshPriorityFn)(const Chunk* chunk, void* context);
+
+void mesh_worker_init();
+void mesh_worker_cleanup();
+void mesh_worker_submit(Chunk* chunk, float priority);
+void mesh_worker_reprioritize(MeshPriorityFn priority, void* context);
+void mesh_worker_upload_finished();
+void mesh_worker_set_upload_budget(size_t bytes, double milliseconds);
+
+#endif  // MESH_WORKER_H
@@ -0,0 +1,638 @@
+// src/mesher.c
+//
+// Geração de malha dos chunks na CPU. Trabalha só sobre um ChunkSnapshot, sem
+// OpenGL nem acesso ao mundo, para poder rodar nas threads de trabalho.
+
+#include "mesher.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mesh_cache.h"
+
+// Geometria das seis faces de um bloco: direção do vizinho que pode escondê-la
+// e os quatro cantos, em sentido anti-horário visto de fora do bloco
+static const struct {
+  int dx, dy, dz;
+  float corners[4][3];
+} faces[6] = {
+    {1, 0, 0, {{1, 0, 1}, {1, 0, 0}, {1, 1, 0}, {1, 1, 1}}},   // X+
+    {-1, 0, 0, {{0, 0, 0}, {0, 0, 1}, {0, 1, 1}, {0, 1, 0}}},  // X-
+    {0, 1, 0, {{0, 1, 1}, {1, 1, 1}, {1, 1, 0}, {0, 1, 0}}},   // Y+
+    {0, -1, 0, {{0, 0, 0}, {1, 0, 0}, {1, 0, 1}, {0, 0, 1}}},  // Y-
+    {0, 0, 1, {{0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}}},   // Z+
+    {0, 0, -1, {{1, 0, 0}, {0, 0, 0}, {0, 1, 0}, {1, 1, 0}}},  // Z-
+};
+
+// Máscaras de coluna: como CHUNK_HEIGHT é 64, cada coluna (x, z) cabe num
+// uint64_t com o bit y ligado quando o bloco é sólido. Com elas a visibilidade
+// das faces sai de deslocamentos e operações lógicas, 64 blocos por vez.
+_Static_assert(CHUNK_HEIGHT <= 64, "As máscaras de coluna usam 64 bits");
+
+typedef struct {
+  // Dimensões da grade em células: o chunk inteiro em blocos, ou reduzido
+  // nos níveis de detalhe, com células de scale blocos de lado
+  int width, height, depth, scale;
+  // Colunas do chunk com uma borda de uma coluna dos chunks vizinhos
+  // (índices deslocados em 1). Sem vizinho a borda fica vazia, ou seja, ar.
+  uint64_t solid[CHUNK_WIDTH + 2][CHUNK_DEPTH + 2];
+  // Faces expostas em cada direção, na ordem da tabela faces[]
+  uint64_t visible[6][CHUNK_WIDTH][CHUNK_DEPTH];
+} ChunkMasks;
+
+// Tipo que representa uma célula de scale blocos de lado: ar se menos da
+// metade dos blocos for sólida; senão o tipo mais comum na camada sólida mais
+// alta da célula, para a superfície manter a grama por cima
+static uint8_t cell_type(const ChunkSnapshot* snapshot, int x0, int y0, int z0,
+                         int scale) {
+  int solid = 0, top = -1;
+  for (int x = x0; x < x0 + scale; x++) {
+    for (int y = y0; y < y0 + scale; y++) {
+      for (int z = z0; z < z0 + scale; z++) {
+        if (snapshot->types[x][y][z] == BLOCK_AIR) continue;
+        solid++;
+        if (y > top) top = y;
+      }
+    }
+  }
+  if (solid * 2 < scale * scale * scale) return BLOCK_AIR;
+
+  uint8_t best = BLOCK_AIR;
+  int best_count = 0;
+  for (int x = x0; x < x0 + scale; x++) {
+    for (int z = z0; z < z0 + scale; z++) {
+      uint8_t type = snapshot->types[x][top][z];
+      if (type == BLOCK_AIR) continue;
+      int count = 0;
+      for (int i = x0; i < x0 + scale; i++) {
+        for (int k = z0; k < z0 + scale; k++) {
+          count += snapshot->types[i][top][k] == type;
+        }
+      }
+      if (count > best_count) {
+        best = type;
+        best_count = count;
+      }
+    }
+  }
+  return best;
+}
+
+// Reduz a borda de um vizinho para células: a célula da borda tem scale
+// colunas de largura, scale camadas de altura e scale colunas de espessura
+// (layers[0] é a coluna encostada no chunk, layers[d] fica d colunas adiante)
+// e é sólida pela mesma regra de cell_type, pelo volume, como o vizinho a vê
+static uint64_t cell_halo(const uint64_t* const layers[CHUNK_HALO_DEPTH],
+                          int first, int scale) {
+  uint64_t layer = (1ULL << scale) - 1;
+  uint64_t cells = 0;
+  for (int y = 0; y < CHUNK_HEIGHT / scale; y++) {
+    int solid = 0;
+    for (int d = 0; d < scale; d++) {
+      for (int i = first; i < first + scale; i++) {
+        solid += __builtin_popcountll(layers[d][i] >> (y * scale) & layer);
+      }
+    }
+    if (solid * 2 >= scale * scale * scale) cells |= 1ULL << y;
+  }
+  return cells;
+}
+
+// Monta em out a versão reduzida do snapshot para o nível de detalhe dele:
+// cada célula vira um "bloco" nos índices baixos de types, e as bordas dos
+// vizinhos são reduzidas do mesmo jeito
+static void downsample(const ChunkSnapshot* snapshot, ChunkSnapshot* out) {
+  int scale = 1 << snapshot->lod;
+  memset(out->types, BLOCK_AIR, sizeof(out->types));
+  for (int x = 0; x < CHUNK_WIDTH / scale; x++) {
+    for (int y = 0; y < CHUNK_HEIGHT / scale; y++) {
+      for (int z = 0; z < CHUNK_DEPTH / scale; z++) {
+        out->types[x][y][z] =
+            cell_type(snapshot, x * scale, y * scale, z * scale, scale);
+      }
+    }
+  }
+  const uint64_t* x_neg[CHUNK_HALO_DEPTH] = {snapshot->halo_x_neg};
+  const uint64_t* x_pos[CHUNK_HALO_DEPTH] = {snapshot->halo_x_pos};
+  const uint64_t* z_neg[CHUNK_HALO_DEPTH] = {snapshot->halo_z_neg};
+  const uint64_t* z_pos[CHUNK_HALO_DEPTH] = {snapshot->halo_z_pos};
+  for (int d = 1; d < CHUNK_HALO_DEPTH; d++) {
+    x_neg[d] = snapshot->halo_x_neg_inner[d - 1];
+    x_pos[d] = snapshot->halo_x_pos_inner[d - 1];
+    z_neg[d] = snapshot->halo_z_neg_inner[d - 1];
+    z_pos[d] = snapshot->halo_z_pos_inner[d - 1];
+  }
+  for (int z = 0; z < CHUNK_DEPTH / scale; z++) {
+    out->halo_x_neg[z] = cell_halo(x_neg, z * scale, scale);
+    out->halo_x_pos[z] = cell_halo(x_pos, z * scale, scale);
+  }
+  for (int x = 0; x < CHUNK_WIDTH / scale; x++) {
+    out->halo_z_neg[x] = cell_halo(z_neg, x * scale, scale);
+    out->halo_z_pos[x] = cell_halo(z_pos, x * scale, scale);
+  }
+  out->lod = snapshot->lod;
+}
+
+// Monta as máscaras da grade de células de lado scale; com scale > 1 o
+// snapshot já deve estar reduzido
+static void build_masks(const ChunkSnapshot* snapshot, int scale,
+                        ChunkMasks* masks) {
+  memset(masks->solid, 0, sizeof(masks->solid));
+  masks->width = CHUNK_WIDTH / scale;
+  masks->height = CHUNK_HEIGHT / scale;
+  masks->depth = CHUNK_DEPTH / scale;
+  masks->scale = scale;
+
+  // Percorre na ordem do array de blocos (z mais interno)
+  for (int x = 0; x < masks->width; x++) {
+    for (int y = 0; y < masks->height; y++) {
+      for (int z = 0; z < masks->depth; z++) {
+        masks->solid[x + 1][z + 1] |=
+            (uint64_t)(snapshot->types[x][y][z] != BLOCK_AIR) << y;
+      }
+    }
+  }
+
+  // Bordas vindas dos vizinhos (as diagonais não escondem nenhuma face)
+  for (int z = 0; z < masks->depth; z++) {
+    masks->solid[0][z + 1] = snapshot->halo_x_neg[z];
+    masks->solid[masks->width + 1][z + 1] = snapshot->halo_x_pos[z];
+  }
+  for (int x = 0; x < masks->width; x++) {
+    masks->solid[x + 1][0] = snapshot->halo_z_neg[x];
+    masks->solid[x + 1][masks->depth + 1] = snapshot->halo_z_pos[x];
+  }
+
+  // Uma face é visível quando o bloco é sólido e o vizinho naquela direção
+  // não é. Em Y o vizinho é o bit adjacente da própria coluna; acima e abaixo
+  // do chunk os deslocamentos trazem zeros, ou seja, ar.
+  for (int x = 0; x < masks->width; x++) {
+    for (int z = 0; z < masks->depth; z++) {
+      uint64_t column = masks->solid[x + 1][z + 1];
+      masks->visible[0][x][z] = column & ~masks->solid[x + 2][z + 1];  // X+
+      masks->visible[1][x][z] = column & ~masks->solid[x][z + 1];      // X-
+      masks->visible[2][x][z] = column & ~(column >> 1);               // Y+
+      masks->visible[3][x][z] = column & ~(column << 1);               // Y-
+      masks->visible[4][x][z] = column & ~masks->solid[x + 1][z + 2];  // Z+
+      masks->visible[5][x][z] = column & ~masks->solid[x + 1][z];      // Z-
+    }
+  }
+}
+
+// Buffers de CPU onde a malha é montada antes do upload
+typedef struct {
+  ChunkQuad* quads;
+  size_t quad_count, max_quads;
+  int scale;  // Lado das células em blocos
+  size_t face_quads[6];
+  int face_plane[6];
+} MeshBuilder;
+
+// Eixos ao longo dos quais as coordenadas u e v da textura variam na face f
+static void face_axes(int f, int* u_axis, int* v_axis) {
+  for (int a = 0; a < 3; a++) {
+    if (faces[f].corners[1][a] != faces[f].corners[0][a]) *u_axis = a;
+    if (faces[f].corners[3][a] != faces[f].corners[0][a]) *v_axis = a;
+  }
+}
+
+// Adiciona um quad da face f com origem na célula (x, y, z). cells[] é a
+// extensão do quad em células em cada eixo (1 no eixo da normal). O registro
+// sai em blocos, multiplicados pelo lado da célula (ver ChunkQuad)
+static int emit_quad(MeshBuilder* mesh, int f, int x, int y, int z,
+                     const int cells[3], BlockType type) {
+  if (mesh->quad_count + 1 > mesh->max_quads) {
+    fprintf(stderr, "Erro: Excedeu a capacidade máxima de quads.\n");
+    return 0;
+  }
+
+  int scale = mesh->scale;
+  int size[3] = {cells[0] * scale, cells[1] * scale, cells[2] * scale};
+  x *= scale;
+  y *= scale;
+  z *= scale;
+
+  // Plano da face ao longo da normal; o grupo guarda o mais favorável
+  int origin[3] = {x, y, z};
+  int normal[3] = {faces[f].dx, faces[f].dy, faces[f].dz};
+  int d = normal[0] ? 0 : (normal[1] ? 1 : 2);
+  int positive = normal[d] > 0;
+  int plane = origin[d] + positive * size[d];
+  if (mesh->face_quads[f] == 0 ||
+      (positive ? plane < mesh->face_plane[f] : plane > mesh->face_plane[f])) {
+    mesh->face_plane[f] = plane;
+  }
+  mesh->face_quads[f]++;
+
+  // O registro guarda o bloco encostado no plano da face, com espessura 1
+  origin[d] = plane - positive;
+  int u_axis = 0, v_axis = 0;
+  face_axes(f, &u_axis, &v_axis);
+  mesh->quads[mesh->quad_count++] =
+      (uint32_t)origin[0] | (uint32_t)origin[1] << 5 |
+      (uint32_t)origin[2] << 11 | (uint32_t)f << 16 | (uint32_t)type << 19 |
+      (uint32_t)(size[u_axis] - 1) << 22 | (uint32_t)(size[v_axis] - 1) << 27;
+  return 1;
+}
+
+// Expande registros de quad em quatro vértices cada, para o caminho de
+// renderização com atributos de vértice
+void mesher_expand_quads(const ChunkQuad* quads, size_t count,
+                         ChunkVertex* vertices) {
+  for (size_t q = 0; q < count; q++) {
+    ChunkQuad quad = quads[q];
+    int origin[3] = {quad & 31, (quad >> 5) & 63, (quad >> 11) & 31};
+    int f = (quad >> 16) & 7;
+    uint32_t type = (quad >> 19) & 7;
+    int width = ((quad >> 22) & 31) + 1;
+    int height = ((quad >> 27) & 31) + 1;
+
+    int u_axis = 0, v_axis = 0;
+    face_axes(f, &u_axis, &v_axis);
+    int size[3] = {1, 1, 1};
+    size[u_axis] = width;
+    size[v_axis] = height;
+    uint32_t material = type | (uint32_t)width << 8 | (uint32_t)height << 15;
+
+    for (int c = 0; c < 4; c++) {
+      ChunkVertex* v = &vertices[q * 4 + c];
+      uint32_t px = origin[0] + faces[f].corners[c][0] * size[0];
+      uint32_t py = origin[1] + faces[f].corners[c][1] * size[1];
+      uint32_t pz = origin[2] + faces[f].corners[c][2] * size[2];
+      v->position = px | py << 6 | pz << 13 | (uint32_t)f << 19 |
+                    (uint32_t)c << 22;
+      v->material = material;
+    }
+  }
+}
+
+// Malha de referência: um quad por face exposta. Percorre só os bits ligados
+// das máscaras de visibilidade, sem testar bloco a bloco. y_filter seleciona
+// as camadas (bits de y) da seção sendo gerada
+static int mesh_faces(const ChunkSnapshot* snapshot, const ChunkMasks* masks,
+                      uint64_t y_filter, MeshBuilder* mesh) {
+  static const int unit[3] = {1, 1, 1};
+
+  for (int f = 0; f < 6; f++) {
+    for (int x = 0; x < masks->width; x++) {
+      for (int z = 0; z < masks->depth; z++) {
+        uint64_t bits = masks->visible[f][x][z] & y_filter;
+        for (; bits; bits &= bits - 1) {
+          int y = __builtin_ctzll(bits);
+          if (!emit_quad(mesh, f, x, y, z, unit,
+                         snapshot->types[x][y][z])) {
+            return 0;
+          }
+        }
+      }
+    }
+  }
+  return 1;
+}
+
+// Malha gulosa: em cada fatia perpendicular à normal, as faces expostas e
+// coplanares do mesmo tipo de bloco são fundidas em retângulos máximos
+static int mesh_greedy(const ChunkSnapshot* snapshot, const ChunkMasks* masks,
+                       uint64_t y_filter, MeshBuilder* mesh) {
+  const int dims[3] = {masks->width, masks->height, masks->depth};
+  BlockType mask[CHUNK_HEIGHT][CHUNK_HEIGHT];
+
+  // Faixa de y coberta pelo filtro (as seções são contíguas)
+  int y_begin = __builtin_ctzll(y_filter);
+  int y_end = 64 - __builtin_clzll(y_filter);
+
+  for (int f = 0; f < 6; f++) {
+    // d: eixo da normal; u e v: eixos do plano da fatia
+    int d = faces[f].dx ? 0 : (faces[f].dy ? 1 : 2);
+    int u = d == 0 ? 2 : 0;
+    int v = d == 1 ? 2 : 1;
+    int v_begin = v == 1 ? y_begin : 0;
+    int v_end = v == 1 ? y_end : dims[v];
+
+    // Fatias sem nenhuma face exposta são puladas sem montar a máscara
+    uint64_t y_slices = 0;
+    uint64_t x_slices = 0, z_slices = 0;
+    for (int x = 0; x < masks->width; x++) {
+      for (int z = 0; z < masks->depth; z++) {
+        uint64_t bits = masks->visible[f][x][z] & y_filter;
+        y_slices |= bits;
+        if (bits) {
+          x_slices |= 1ULL << x;
+          z_slices |= 1ULL << z;
+        }
+      }
+    }
+    uint64_t slices = d == 0 ? x_slices : (d == 1 ? y_slices : z_slices);
+
+    for (; slices; slices &= slices - 1) {
+      int slice = __builtin_ctzll(slices);
+
+      // Tipo do bloco cuja face está exposta em cada célula (ou ar)
+      for (int j = v_begin; j < v_end; j++) {
+        for (int i = 0; i < dims[u]; i++) {
+          int pos[3];
+          pos[d] = slice;
+          pos[u] = i;
+          pos[v] = j;
+          uint64_t bits = masks->visible[f][pos[0]][pos[2]] & y_filter;
+          int visible = (bits >> pos[1]) & 1;
+          mask[j][i] =
+              visible ? snapshot->types[pos[0]][pos[1]][pos[2]] : BLOCK_AIR;
+        }
+      }
+
+      for (int j = v_begin; j < v_end; j++) {
+        for (int i = 0; i < dims[u];) {
+          BlockType type = mask[j][i];
+          if (type == BLOCK_AIR) {
+            i++;
+            continue;
+          }
+
+          // Estende ao longo de u e depois de v enquanto a linha inteira
+          // tiver o mesmo tipo
+          int width = 1;
+          while (i + width < dims[u] && mask[j][i + width] == type) width++;
+
+          int height = 1;
+          for (; j + height < v_end; height++) {
+            int k = 0;
+            while (k < width && mask[j + height][i + k] == type) k++;
+            if (k < width) break;
+          }
+
+          for (int h = 0; h < height; h++) {
+            for (int k = 0; k < width; k++) mask[j + h][i + k] = BLOCK_AIR;
+          }
+
+          int origin[3], size[3] = {1, 1, 1};
+          origin[d] = slice;
+          origin[u] = i;
+          origin[v] = j;
+          size[u] = width;
+          size[v] = height;
+          if (!emit_quad(mesh, f, origin[0], origin[1], origin[2], size,
+                         type)) {
+            return 0;
+          }
+          i += width;
+        }
+      }
+    }
+  }
+  return 1;
+}
+
+// Área de rascunho da geração de malha, uma por thread. É alocada na primeira
+// vez, reaproveitada entre chamadas e só cresce (dobrando) quando uma malha não
+// cabe; assim editar um bloco não toca dezenas de MiB de páginas novas.
+typedef struct {
+  ChunkMasks masks;
+  ChunkSnapshot reduced;  // Snapshot reduzido dos níveis de detalhe
+  ChunkQuad* quads;
+  size_t quad_capacity;
+} MeshScratch;
+
+static _Thread_local MeshScratch* scratch;
+
+// Número de faces expostas nas camadas do filtro; limita por cima os quads de
+// qualquer modo
+static size_t count_visible_faces(const ChunkMasks* masks, uint64_t y_filter) {
+  size_t count = 0;
+  for (int f = 0; f < 6; f++) {
+    for (int x = 0; x < masks->width; x++) {
+      for (int z = 0; z < masks->depth; z++) {
+        count += __builtin_popcountll(masks->visible[f][x][z] & y_filter);
+      }
+    }
+  }
+  return count;
+}
+
+static MeshScratch* scratch_get() {
+  if (!scratch) scratch = calloc(1, sizeof(MeshScratch));
+  return scratch;
+}
+
+static int scratch_reserve(MeshScratch* arena, size_t quads) {
+  if (quads <= arena->quad_capacity) return 1;
+
+  size_t capacity = arena->quad_capacity ? arena->quad_capacity : 1024;
+  while (capacity < quads) capacity *= 2;
+
+  ChunkQuad* grown = realloc(arena->quads, capacity * sizeof(ChunkQuad));
+  if (!grown) return 0;
+  arena->quads = grown;
+
+  arena->quad_capacity = capacity;
+  return 1;
+}
+
+// Libera a área de rascunho da thread atual
+void mesher_free_scratch() {
+  if (!scratch) return;
+  free(scratch->quads);
+  free(scratch);
+  scratch = NULL;
+}
+
+// Copia a malha montada na área de rascunho para buffers de tamanho exato,
+// que passam a pertencer a quem chamou
+static int mesh_copy_out(const MeshBuilder* mesh, ChunkMesh* out_mesh) {
+  out_mesh->quad_count = mesh->quad_count;
+  out_mesh->quads = NULL;
+  memcpy(out_mesh->face_quads, mesh->face_quads, sizeof(mesh->face_quads));
+  memcpy(out_mesh->face_plane, mesh->face_plane, sizeof(mesh->face_plane));
+  if (mesh->quad_count == 0) return 1;
+
+  size_t quad_bytes = mesh->quad_count * sizeof(ChunkQuad);
+  out_mesh->quads = malloc(quad_bytes);
+  if (!out_mesh->quads) {
+    out_mesh->quad_count = 0;
+    return 0;
+  }
+  memcpy(out_mesh->quads, mesh->quads, quad_bytes);
+  return 1;
+}
+
+void mesher_free_mesh(ChunkMesh* mesh) {
+  free(mesh->quads);
+  mesh->quads = NULL;
+  mesh->quad_count = 0;
+}
+
+// Gera a malha das seções marcadas em sections (bit s = seção s). As máscaras
+// são montadas uma vez para o chunk todo, já que a visibilidade na fronteira
+// de uma seção depende da camada vizinha. Cada out_sections[s] recebe buffers
+// próprios, que devem ser liberados com mesher_free_mesh.
+int mesher_build(const ChunkSnapshot* snapshot, MeshMode mode,
+                 unsigned sections, ChunkMesh out_sections[CHUNK_SECTIONS]) {
+  MeshScratch* arena = scratch_get();
+  if (!arena) {
+    fprintf(stderr, "Erro: Falha ao alocar memória para mesh.\n");
+    return 0;
+  }
+
+  // Seções cujo conteúdo já foi visto saem do cache de malhas; se todas
+  // saírem, nem as máscaras precisam ser montadas
+  int cached = mesh_cache_enabled();
+  uint64_t keys[CHUNK_SECTIONS] = {0};
+  for (int s = 0; s < CHUNK_SECTIONS && cached; s++) {
+    if (!(sections & (1u << s))) continue;
+    keys[s] = mesh_cache_key(snapshot, mode, s);
+    if (mesh_cache_get(keys[s], s, &out_sections[s])) sections &= ~(1u << s);
+  }
+  if (!sections) return 1;
+
+  // Nos níveis de detalhe a malha é gerada sobre as células reduzidas; cada
+  // seção continua cobrindo as mesmas camadas de blocos
+  int scale = 1 << snapshot->lod;
+  if (scale > 1) {
+    downsample(snapshot, &arena->reduced);
+    snapshot = &arena->reduced;
+  }
+  build_masks(snapshot, scale, &arena->masks);
+  int section_cells = CHUNK_SECTION_HEIGHT / scale;
+
+  for (int s = 0; s < CHUNK_SECTIONS; s++) {
+    if (!(sections & (1u << s))) continue;
+
+    uint64_t y_filter = ((1ULL << section_cells) - 1) << (s * section_cells);
+
+    // Reserva só o necessário para as faces realmente expostas
+    size_t max_quads = count_visible_faces(&arena->masks, y_filter);
+    if (!scratch_reserve(arena, max_quads)) {
+      fprintf(stderr, "Erro: Falha ao alocar memória para mesh.\n");
+      return 0;
+    }
+
+    MeshBuilder mesh = {0};
+    mesh.quads = arena->quads;
+    mesh.max_quads = max_quads;
+    mesh.scale = scale;
+
+    int ok = mode == MESH_MODE_GREEDY
+                 ? mesh_greedy(snapshot, &arena->masks, y_filter, &mesh)
+                 : mesh_faces(snapshot, &arena->masks, y_filter, &mesh);
+    if (!ok || !mesh_copy_out(&mesh, &out_sections[s])) return 0;
+    if (cached) mesh_cache_put(keys[s], s, &out_sections[s]);
+  }
+  return 1;
+}
+
+// Chunks esparsos podem ser desenhados como cubos instanciados, sem malha:
+// cada bloco exposto custa 12 triângulos e 4 bytes, contra 2 triângulos e 4
+// bytes por quad da malha. Os cubos só são usados quando não desenham mais de
+// INSTANCE_TRIANGLE_PERCENT% dos triângulos da malha no modo ativo; a folga
+// paga a troca por um upload menor e uma geração mais barata. Na prática isso
+// só acontece com blocos soltos, cujas faces nem a malha gulosa funde (ver
+// make bench-mesh: os triângulos dos dois caminhos, caso a caso). A contagem
+// de sólidos limitada por INSTANCE_MAX_BLOCKS descarta os chunks cheios antes
+// de qualquer outra coisa
+#define INSTANCE_MAX_BLOCKS 1024
+#define INSTANCE_TRIANGLE_PERCENT 125
+
+// Quads da malha do snapshot inteiro no modo dado, no nível de detalhe dele,
+// sem copiar a malha nem passar pelo cache. Reaproveita (e sobrescreve) as
+// máscaras da área de rascunho. Retorna SIZE_MAX se faltar memória
+static size_t count_mesh_quads(MeshScratch* arena,
+                               const ChunkSnapshot* snapshot, MeshMode mode) {
+  int scale = 1 << snapshot->lod;
+  if (scale > 1) {
+    downsample(snapshot, &arena->reduced);
+    snapshot = &arena->reduced;
+  }
+  build_masks(snapshot, scale, &arena->masks);
+  int section_cells = CHUNK_SECTION_HEIGHT / scale;
+
+  size_t quads = 0;
+  for (int s = 0; s < CHUNK_SECTIONS; s++) {
+    uint64_t y_filter = ((1ULL << section_cells) - 1) << (s * section_cells);
+    size_t max_quads = count_visible_faces(&arena->masks, y_filter);
+    if (mode != MESH_MODE_GREEDY) {
+      quads += max_quads;
+      continue;
+    }
+    if (!scratch_reserve(arena, max_quads)) return SIZE_MAX;
+    MeshBuilder mesh = {0};
+    mesh.quads = arena->quads;
+    mesh.max_quads = max_quads;
+    mesh.scale = scale;
+    if (!mesh_greedy(snapshot, &arena->masks, y_filter, &mesh)) {
+      return SIZE_MAX;
+    }
+    quads += mesh.quad_count;
+  }
+  return quads;
+}
+
+// Decide se o chunk é esparso e, se for, devolve em out_instances (buffer
+// próprio, liberado com free) um registro por bloco exposto. Retorna 0 se o
+// chunk deve ter malha no modo mode. Os cubos usam sempre os blocos em
+// resolução cheia; a comparação é com a malha no nível de detalhe do snapshot
+int mesher_build_instances(const ChunkSnapshot* snapshot, MeshMode mode,
+                           ChunkInstance** out_instances, size_t* out_count) {
+  *out_instances = NULL;
+  *out_count = 0;
+
+  // Os blocos expostos nunca passam do total de sólidos: uma contagem rápida
+  // descarta os chunks cheios sem montar as máscaras
+  const uint8_t* types = &snapshot->types[0][0][0];
+  size_t solid = 0;
+  for (size_t i = 0; i < sizeof(snapshot->types); i++) {
+    solid += types[i] != BLOCK_AIR;
+  }
+  if (solid == 0 || solid > INSTANCE_MAX_BLOCKS) return 0;
+
+  MeshScratch* arena = scratch_get();
+  if (!arena) return 0;
+  ChunkMasks* masks = &arena->masks;
+
+  // A malha nunca tem mais quads que faces expostas: se nem assim os cubos
+  // compensam, a malha do modo ativo nem precisa ser contada
+  build_masks(snapshot, 1, masks);
+  size_t blocks = 0, exposed_faces = 0;
+  for (int x = 0; x < CHUNK_WIDTH; x++) {
+    for (int z = 0; z < CHUNK_DEPTH; z++) {
+      uint64_t exposed = 0;
+      for (int f = 0; f < 6; f++) {
+        exposed |= masks->visible[f][x][z];
+        exposed_faces += __builtin_popcountll(masks->visible[f][x][z]);
+      }
+      blocks += __builtin_popcountll(exposed);
+    }
+  }
+  if (blocks == 0 ||
+      blocks * 12 * 100 > exposed_faces * 2 * INSTANCE_TRIANGLE_PERCENT) {
+    return 0;
+  }
+  if (snapshot->lod > 0 || mode != MESH_MODE_FACES) {
+    size_t quads = count_mesh_quads(arena, snapshot, mode);
+    if (quads == SIZE_MAX ||
+        blocks * 12 * 100 > quads * 2 * INSTANCE_TRIANGLE_PERCENT) {
+      return 0;
+    }
+    build_masks(snapshot, 1, masks);
+  }
+
+  ChunkInstance* instances = malloc(blocks * sizeof(ChunkInstance));
+  if (!instances) return 0;
+  size_t count = 0;
+  for (int x = 0; x < CHUNK_WIDTH; x++) {
+    for (int z = 0; z < CHUNK_DEPTH; z++) {
+      uint64_t exposed = 0;
+      for (int f = 0; f < 6; f++) exposed |= masks->visible[f][x][z];
+      while (exposed) {
+        int y = __builtin_ctzll(exposed);
+        exposed &= exposed - 1;
+        instances[count++] = (ChunkInstance)x | (ChunkInstance)y << 5 |
+                             (ChunkInstance)z << 11 |
+                             (ChunkInstance)snapshot->types[x][y][z] << 16;
+      }
+    }
+  }
+  *out_instances = instances;
+  *out_count = count;
+  return 1;
+}
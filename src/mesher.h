@@ -0,0 +1,17 @@
+// src/mesher.h
+
+#ifndef MESHER_H
+#define MESHER_H
+
+#include "chunk.h"
+
+int mesher_build(const ChunkSnapshot* snapshot, MeshMode mode,
+                 unsigned sections, ChunkMesh out_sections[CHUNK_SECTIONS]);
+int mesher_build_instances(const ChunkSnapshot* snapshot, MeshMode mode,
+                           ChunkInstance** out_instances, size_t* out_count);
+void mesher_free_mesh(ChunkMesh* mesh);
+void mesher_expand_quads(const ChunkQuad* quads, size_t count,
+                         ChunkVertex* vertices);
+void mesher_free_scratch();
+
+#endif  // MESHER_H
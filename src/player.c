@@ -15,6 +15,7 @@ static vec3 front = {0.0f, 0.0f, -1.0f};
 static vec3 up = {0.0f, 1.0f, 0.0f};
 static vec3 right;
 static vec3 world_up = {0.0f, 1.0f, 0.0f};
+static vec3 velocity = {0.0f, 0.0f, 0.0f};  // Velocidade efetiva (blocos/s)
 
 static mat4 view_matrix;
 
@@ -45,11 +46,15 @@ void player_reset_position() {
 
   vertical_speed = 0.0f;
   is_jumping = 0;
+  glm_vec3_zero(velocity);
 }
 
 static int check_collision(vec3 new_position);
 
 void player_update(float deltaTime, GLFWwindow* window) {
+  vec3 previous_position;
+  glm_vec3_copy(position, previous_position);
+
   float current_speed = 0.0f;
   const float max_speed = 5.0f;
 
@@ -82,6 +87,8 @@ void player_update(float deltaTime, GLFWwindow* window) {
   }
   if (glfwGetKey(window, GLFW_KEY_F5) == GLFW_PRESS) {
     player_reset_position();
+    // O teletransporte não conta como deslocamento na velocidade
+    glm_vec3_copy(position, previous_position);
   }
 
   if (glfwGetKey(window, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS ||
@@ -162,9 +169,17 @@ void player_update(float deltaTime, GLFWwindow* window) {
     while (check_collision(adjusted_position)) {
       adjusted_position[1] += 0.1f;  // Eleva gradualmente até não colidir
     }
+    // O empurrão para fora do bloco também fica fora da velocidade
+    previous_position[1] += adjusted_position[1] - position[1];
     glm_vec3_copy(adjusted_position, position);
   }
 
+  // Velocidade efetiva após colisões (usada na pré-carga de chunks)
+  if (deltaTime > 0.0f) {
+    glm_vec3_sub(position, previous_position, velocity);
+    glm_vec3_scale(velocity, 1.0f / deltaTime, velocity);
+  }
+
   // Atualiza a matriz de visão
   vec3 target;
   glm_vec3_add(position, front, target);
@@ -264,6 +279,12 @@ void player_get_position(vec3 out_position) {
   glm_vec3_copy(position, out_position);
 }
 
+void player_get_velocity(vec3 out_velocity) {
+  glm_vec3_copy(velocity, out_velocity);
+}
+
+void player_get_front(vec3 out_front) { glm_vec3_copy(front, out_front); }
+
 // Função para realizar o ray casting
 static int raycast(vec3 origin, vec3 direction, vec3* out_block,
                    vec3* out_adjacent) {
@@ -13,6 +13,8 @@ void player_process_mouse(double xpos, double ypos);
 void player_get_view_matrix(float* view_matrix);
 void player_reset_position();
 void player_get_position(vec3 out_position);
+void player_get_velocity(vec3 out_velocity);
+void player_get_front(vec3 out_front);
 void player_break_block();
 void player_place_block();
 
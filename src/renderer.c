@@ -3,19 +3,36 @@
 #include "renderer.h"
 
 #include <cglm/cglm.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "block.h"
 #include "camera.h"
+#include "gpu_mesher.h"
+#include "mesh_worker.h"
 #include "player.h"
+#include "shader_cache.h"
+#include "texture_cache.h"
 #include "world.h"
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
+
+// Alcance de renderização (em chunks) ao redor do jogador
+#define RENDER_DISTANCE 8
+
+// Distância (em chunks) até a qual cada nível de detalhe é usado; além da
+// última, o nível mais grosso
+static const int lod_distances[CHUNK_LOD_LEVELS - 1] = {1, 3};
+
+// Pré-carga de chunks: quantos segundos à frente do movimento do jogador a
+// malha deve estar pronta, e quantos chunks podem ser preparados por quadro
+#define PREFETCH_SECONDS 2.0f
+#define PREFETCH_CHUNKS_PER_FRAME 1
+#define PREFETCH_WALK_SPEED 5.0f  // Velocidade assumida quando parado
 
 // Variáveis e recursos de renderização
 static GLuint shaderProgram;
+static GLuint instancedProgram;  // Chunks esparsos, desenhados como cubos
 static GLuint VAO, VBO, EBO;
 static GLuint textures[3];  // Texturas para grama, terra e pedra
 
@@ -55,36 +72,86 @@ static GLuint compile_shader(const char* source, GLenum type) {
   return shader;
 }
 
-void renderer_init() {
-  // Inicializa shaders, carrega texturas, configura buffers
-
-  // Carrega e compila os shaders
-  char* vertexShaderSource = read_file("assets/shaders/vertex_shader.glsl");
-  char* fragmentShaderSource = read_file("assets/shaders/fragment_shader.glsl");
-  GLuint vertexShader = compile_shader(vertexShaderSource, GL_VERTEX_SHADER);
-  GLuint fragmentShader =
-      compile_shader(fragmentShaderSource, GL_FRAGMENT_SHADER);
-
-  // Cria o programa de shader
-  shaderProgram = glCreateProgram();
-  glAttachShader(shaderProgram, vertexShader);
-  glAttachShader(shaderProgram, fragmentShader);
-  glLinkProgram(shaderProgram);
+// Linka o programa com os shaders já compilados, que são liberados em
+// seguida. Retorna 0 se a linkagem falhar
+static GLuint link_program(const GLuint* shaders, int count) {
+  GLuint program = glCreateProgram();
+  for (int i = 0; i < count; i++) glAttachShader(program, shaders[i]);
+  if (shader_cache_supported()) {
+    glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+  }
+  glLinkProgram(program);
 
   // Verifica erros de linkagem
   int success;
   char infoLog[512];
-  glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+  glGetProgramiv(program, GL_LINK_STATUS, &success);
+  for (int i = 0; i < count; i++) glDeleteShader(shaders[i]);
   if (!success) {
-    glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
+    glGetProgramInfoLog(program, 512, NULL, infoLog);
     fprintf(stderr, "Erro na linkagem do programa de shader: %s\n", infoLog);
+    glDeleteProgram(program);
+    return 0;
+  }
+  return program;
+}
+
+// Compila e linka o programa a partir do código-fonte dos shaders
+static GLuint build_program(const char* vertexShaderSource,
+                            const char* fragmentShaderSource) {
+  GLuint shaders[] = {
+      compile_shader(vertexShaderSource, GL_VERTEX_SHADER),
+      compile_shader(fragmentShaderSource, GL_FRAGMENT_SHADER),
+  };
+  return link_program(shaders, 2);
+}
+
+// Carrega o programa dos shaders indicados; o programa linkado vem do cache
+// quando possível. Retorna 0 se não for possível montá-lo
+static GLuint load_program(const char* name, const char* vertex_file,
+                           const char* fragment_file) {
+  char* vertexShaderSource = read_file(vertex_file);
+  char* fragmentShaderSource = read_file(fragment_file);
+  if (!vertexShaderSource || !fragmentShaderSource) {
+    free(vertexShaderSource);
+    free(fragmentShaderSource);
+    return 0;
+  }
+  const char* sources[] = {vertexShaderSource, fragmentShaderSource};
+  uint64_t program_key = shader_cache_key(sources, 2);
+
+  GLuint program = shader_cache_load(name, program_key);
+  if (!program) {
+    program = build_program(vertexShaderSource, fragmentShaderSource);
+    if (program) shader_cache_store(name, program_key, program);
   }
-  glDeleteShader(vertexShader);
-  glDeleteShader(fragmentShader);
   free(vertexShaderSource);
   free(fragmentShaderSource);
+  return program;
+}
 
-  // Configura os dados dos vértices (um cubo)
+// Como load_program, para um compute shader sozinho
+static GLuint load_compute_program(const char* name, const char* file) {
+  char* source = read_file(file);
+  if (!source) return 0;
+  const char* sources[] = {source};
+  uint64_t program_key = shader_cache_key(sources, 1);
+
+  GLuint program = shader_cache_load(name, program_key);
+  if (!program) {
+    GLuint shader = compile_shader(source, GL_COMPUTE_SHADER);
+    program = link_program(&shader, 1);
+    if (program) shader_cache_store(name, program_key, program);
+  }
+  free(source);
+  return program;
+}
+
+// Cubo unitário com coordenadas de textura, desenhado uma vez por bloco
+// exposto dos chunks esparsos
+static void init_cube() {
+  // Configura os dados dos vértices (um cubo). As coordenadas de textura de
+  // cada face seguem a orientação da malha dos chunks (ver src/mesher.c)
   float vertices[] = {
       // Posições          // Coordenadas de textura
       // Frente
@@ -93,30 +160,30 @@ void renderer_init() {
       0.5f, 0.5f, 0.5f, 1.0f, 1.0f,    // Superior direito
       -0.5f, 0.5f, 0.5f, 0.0f, 1.0f,   // Superior esquerdo
       // Traseira
-      -0.5f, -0.5f, -0.5f, 0.0f, 0.0f,  // Inferior esquerdo
-      0.5f, -0.5f, -0.5f, 1.0f, 0.0f,   // Inferior direito
-      0.5f, 0.5f, -0.5f, 1.0f, 1.0f,    // Superior direito
-      -0.5f, 0.5f, -0.5f, 0.0f, 1.0f,   // Superior esquerdo
+      -0.5f, -0.5f, -0.5f, 1.0f, 0.0f,  // Inferior esquerdo
+      0.5f, -0.5f, -0.5f, 0.0f, 0.0f,   // Inferior direito
+      0.5f, 0.5f, -0.5f, 0.0f, 1.0f,    // Superior direito
+      -0.5f, 0.5f, -0.5f, 1.0f, 1.0f,   // Superior esquerdo
       // Esquerda
       -0.5f, -0.5f, -0.5f, 0.0f, 0.0f,  // Inferior esquerdo
       -0.5f, -0.5f, 0.5f, 1.0f, 0.0f,   // Inferior direito
       -0.5f, 0.5f, 0.5f, 1.0f, 1.0f,    // Superior direito
       -0.5f, 0.5f, -0.5f, 0.0f, 1.0f,   // Superior esquerdo
                                         // Direita
-      0.5f, -0.5f, -0.5f, 0.0f, 0.0f,   // Inferior esquerdo
-      0.5f, -0.5f, 0.5f, 1.0f, 0.0f,    // Inferior direito
-      0.5f, 0.5f, 0.5f, 1.0f, 1.0f,     // Superior direito
-      0.5f, 0.5f, -0.5f, 0.0f, 1.0f,    // Superior esquerdo
+      0.5f, -0.5f, -0.5f, 1.0f, 0.0f,   // Inferior esquerdo
+      0.5f, -0.5f, 0.5f, 0.0f, 0.0f,    // Inferior direito
+      0.5f, 0.5f, 0.5f, 0.0f, 1.0f,     // Superior direito
+      0.5f, 0.5f, -0.5f, 1.0f, 1.0f,    // Superior esquerdo
       // Superior
       -0.5f, 0.5f, 0.5f, 0.0f, 0.0f,   // Inferior esquerdo
       0.5f, 0.5f, 0.5f, 1.0f, 0.0f,    // Inferior direito
       0.5f, 0.5f, -0.5f, 1.0f, 1.0f,   // Superior direito
       -0.5f, 0.5f, -0.5f, 0.0f, 1.0f,  // Superior esquerdo
       // Inferior
-      -0.5f, -0.5f, 0.5f, 0.0f, 0.0f,   // Inferior esquerdo
-      0.5f, -0.5f, 0.5f, 1.0f, 0.0f,    // Inferior direito
-      0.5f, -0.5f, -0.5f, 1.0f, 1.0f,   // Superior direito
-      -0.5f, -0.5f, -0.5f, 0.0f, 1.0f,  // Superior esquerdo
+      -0.5f, -0.5f, 0.5f, 0.0f, 1.0f,   // Inferior esquerdo
+      0.5f, -0.5f, 0.5f, 1.0f, 1.0f,    // Inferior direito
+      0.5f, -0.5f, -0.5f, 1.0f, 0.0f,   // Superior direito
+      -0.5f, -0.5f, -0.5f, 0.0f, 0.0f,  // Superior esquerdo
   };
 
   unsigned int indices[] = {
@@ -193,7 +260,12 @@ void renderer_init() {
                         (void*)(3 * sizeof(float)));
   glEnableVertexAttribArray(1);
 
-  // Carrega texturas
+  // Os chunks esparsos desenham este cubo, uma instância por bloco
+  chunk_set_instance_cube(VBO, EBO);
+}
+
+// Cria as texturas dos blocos e envia as imagens, com os mipmaps
+static void init_textures() {
   const char* texture_files[] = {"assets/textures/grass.png",
                                  "assets/textures/dirt.png",
                                  "assets/textures/stone.png"};
@@ -204,25 +276,65 @@ void renderer_init() {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    int width, height, nrChannels;
-    unsigned char* data =
-        stbi_load(texture_files[i], &width, &height, &nrChannels, 0);
-    if (data) {
-      GLenum format = nrChannels == 4 ? GL_RGBA : GL_RGB;
-      glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format,
-                   GL_UNSIGNED_BYTE, data);
-      glGenerateMipmap(GL_TEXTURE_2D);
-    } else {
-      fprintf(stderr, "Falha ao carregar a textura %s\n", texture_files[i]);
+  }
+  // Usa as imagens já decodificadas (com mipmaps) do cache em disco
+  if (!texture_cache_load(texture_files, 3, textures)) {
+    fprintf(stderr, "Falha ao carregar as texturas dos blocos\n");
+  }
+}
+
+void renderer_init() {
+  // Inicializa shaders, carrega texturas, configura buffers
+
+  // Com GL 4.3 os chunks são desenhados por vertex pulling, lendo os quads
+  // de um storage buffer; senão, com os vértices expandidos na CPU
+  shaderProgram = 0;
+  if (GLEW_VERSION_4_3) {
+    shaderProgram = load_program("block_program_pulling",
+                                 "assets/shaders/vertex_pulling.glsl",
+                                 "assets/shaders/fragment_shader.glsl");
+  }
+  chunk_set_vertex_pulling(shaderProgram != 0);
+
+  // Geração de malha na GPU, se pedida: escreve registros de quad, então
+  // depende do vertex pulling
+  GLuint meshProgram = 0;
+  if (gpu_mesher_enabled()) {
+    if (shaderProgram) {
+      meshProgram = load_compute_program("mesher_compute_program",
+                                         "assets/shaders/mesher_compute.glsl");
+    }
+    if (!meshProgram) {
+      fprintf(stderr, "Geração de malha na GPU indisponível; usando a CPU\n");
     }
-    stbi_image_free(data);
   }
+  gpu_mesher_init(meshProgram);
+
+  if (!shaderProgram) {
+    shaderProgram = load_program("block_program",
+                                 "assets/shaders/vertex_shader.glsl",
+                                 "assets/shaders/fragment_shader.glsl");
+  }
+  instancedProgram = load_program("instanced_program",
+                                  "assets/shaders/instanced_cube.glsl",
+                                  "assets/shaders/fragment_shader.glsl");
+
+  // O cubo é criado uma vez só e sobrevive aos resets: os VAOs dos chunks
+  // instanciados guardam os buffers dele
+  if (!VAO) init_cube();
+
+  // As texturas também são carregadas uma vez só: um reset refaz apenas os
+  // programas
+  if (!textures[0]) init_textures();
 
   // Define os uniforms das texturas
-  glUseProgram(shaderProgram);
-  glUniform1i(glGetUniformLocation(shaderProgram, "grassTexture"), 0);
-  glUniform1i(glGetUniformLocation(shaderProgram, "dirtTexture"), 1);
-  glUniform1i(glGetUniformLocation(shaderProgram, "stoneTexture"), 2);
+  GLuint programs[] = {shaderProgram, instancedProgram};
+  for (int i = 0; i < 2; i++) {
+    glUseProgram(programs[i]);
+    glUniform1i(glGetUniformLocation(programs[i], "grassTexture"), 0);
+    glUniform1i(glGetUniformLocation(programs[i], "dirtTexture"), 1);
+    glUniform1i(glGetUniformLocation(programs[i], "stoneTexture"), 2);
+  }
 
   // Ativa e vincula texturas às unidades de textura correspondentes
   glActiveTexture(GL_TEXTURE0);
@@ -240,25 +352,141 @@ void renderer_init() {
   glEnable(GL_DEPTH_TEST);
 }
 
+// Chunks fora do campo de visão só têm a malha gerada depois de todos os que
+// estão na tela
+#define OUT_OF_VIEW_PRIORITY 1.0e7f
+
+// Planos do frustum de visão do quadro atual
+static vec4 frustum_planes[6];
+
+// Prioridade do chunk na fila de geração de malha (menor primeiro): distância
+// ao quadrado do jogador até o centro do chunk, depois dos visíveis se estiver
+// fora do frustum
+static float mesh_priority(vec3 player_position, int cx, int cz) {
+  vec3 box[2] = {
+      {cx * CHUNK_WIDTH, 0.0f, cz * CHUNK_DEPTH},
+      {(cx + 1) * CHUNK_WIDTH, CHUNK_HEIGHT, (cz + 1) * CHUNK_DEPTH},
+  };
+  float dx = (cx + 0.5f) * CHUNK_WIDTH - player_position[0];
+  float dz = (cz + 0.5f) * CHUNK_DEPTH - player_position[2];
+  float priority = dx * dx + dz * dz;
+  if (!glm_aabb_frustum(box, frustum_planes)) priority += OUT_OF_VIEW_PRIORITY;
+  return priority;
+}
+
+// mesh_priority para a fila de geração, com a posição do jogador no contexto
+static float requeue_priority(const Chunk* chunk, void* player_position) {
+  return mesh_priority(player_position, chunk->x, chunk->z);
+}
+
+// Nível de detalhe de um chunk pela distância ao chunk do jogador
+static int lod_for_chunk(int cx, int cz, int player_chunk_x,
+                         int player_chunk_z) {
+  int distance = abs(cx - player_chunk_x);
+  if (abs(cz - player_chunk_z) > distance) distance = abs(cz - player_chunk_z);
+
+  int lod = 0;
+  while (lod < CHUNK_LOD_LEVELS - 1 && distance > lod_distances[lod]) lod++;
+  return lod;
+}
+
+// Agenda a malha dos chunks para onde o jogador está indo, antes que eles
+// entrem no alcance de renderização. A trajetória é extrapolada em linha reta
+// a partir da velocidade atual (ou da direção do olhar, se estiver parado) e
+// amostrada a cada meio chunk. Roda depois dos chunks visíveis e com um limite
+// por quadro, para os jobs entrarem na fila atrás do que já está na tela. Com
+// submit = 0 só acerta o nível de detalhe dos chunks do caminho, sem limite:
+// todos os níveis do quadro são definidos antes do primeiro job, senão um
+// chunk sairia com a costura de um vizinho que ainda vai mudar de nível.
+static void prefetch_chunks(vec3 player_position, int player_chunk_x,
+                            int player_chunk_z, int submit) {
+  vec3 heading;
+  player_get_velocity(heading);
+  heading[1] = 0.0f;  // Chunks só variam no plano XZ
+  if (glm_vec3_norm(heading) < 0.01f) {
+    player_get_front(heading);
+    heading[1] = 0.0f;
+    if (glm_vec3_norm(heading) < 0.01f) return;
+    glm_vec3_normalize(heading);
+    glm_vec3_scale(heading, PREFETCH_WALK_SPEED, heading);
+  }
+
+  vec3 travel;
+  glm_vec3_scale(heading, PREFETCH_SECONDS, travel);
+  float distance = glm_vec3_norm(travel);
+  int steps = (int)ceilf(distance / (CHUNK_WIDTH / 2.0f));
+
+  int budget = PREFETCH_CHUNKS_PER_FRAME;
+  for (int step = 1; step <= steps && budget > 0; step++) {
+    float t = (float)step / steps;
+    int ahead_x =
+        (int)floorf((player_position[0] + travel[0] * t) / CHUNK_WIDTH);
+    int ahead_z =
+        (int)floorf((player_position[2] + travel[2] * t) / CHUNK_DEPTH);
+
+    for (int cx = ahead_x - RENDER_DISTANCE;
+         cx <= ahead_x + RENDER_DISTANCE && budget > 0; cx++) {
+      for (int cz = ahead_z - RENDER_DISTANCE;
+           cz <= ahead_z + RENDER_DISTANCE && budget > 0; cz++) {
+        // Chunks dentro do alcance atual já foram tratados no desenho
+        if (abs(cx - player_chunk_x) <= RENDER_DISTANCE &&
+            abs(cz - player_chunk_z) <= RENDER_DISTANCE) {
+          continue;
+        }
+        Chunk* chunk = world_get_chunk(cx, cz);
+        if (!chunk) continue;
+        if (!submit) {
+          chunk_set_lod(chunk, lod_for_chunk(cx, cz, player_chunk_x,
+                                             player_chunk_z));
+          continue;
+        }
+        if (!chunk->needs_update || chunk->mesh_pending) continue;
+
+        mesh_worker_submit(chunk, mesh_priority(player_position, cx, cz));
+        budget--;
+      }
+    }
+  }
+}
+
 void renderer_clear() {
   // Limpa o buffer de cor e profundidade
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
-void renderer_draw_world() {
-  // Usa o programa de shader
-  glUseProgram(shaderProgram);
+// Passa ao programa as matrizes de visualização e projeção do quadro e
+// retorna a posição do uniform com a origem de cada chunk
+static GLint set_view_uniforms(GLuint program, mat4 view_matrix) {
+  glUseProgram(program);
+  glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE,
+                     (float*)view_matrix);
+  glUniformMatrix4fv(glGetUniformLocation(program, "projection"), 1,
+                     GL_FALSE, camera_get_projection_matrix());
+  return glGetUniformLocation(program, "chunkOrigin");
+}
 
-  // Configura as matrizes de visualização e projeção
-  GLint viewLoc = glGetUniformLocation(shaderProgram, "view");
-  GLint projLoc = glGetUniformLocation(shaderProgram, "projection");
+// Define a origem do chunk (cx, cz) no programa em uso. Os vértices guardam
+// só a posição local ao chunk, em inteiros pequenos; o shader soma a origem
+static void set_chunk_origin(GLint location, int cx, int cz) {
+  glUniform3i(location, cx * CHUNK_WIDTH, 0, cz * CHUNK_DEPTH);
+}
+
+void renderer_draw_world() {
+  // Envia para a GPU as malhas que as threads de trabalho terminaram
+  mesh_worker_upload_finished();
 
   // Obter a matriz de visão do jogador
   mat4 view_matrix;
   player_get_view_matrix((float*)view_matrix);
 
-  glUniformMatrix4fv(viewLoc, 1, GL_FALSE, (float*)view_matrix);
-  glUniformMatrix4fv(projLoc, 1, GL_FALSE, camera_get_projection_matrix());
+  // Usa o programa de shader, com as matrizes de visualização e projeção
+  GLint origin_location = set_view_uniforms(shaderProgram, view_matrix);
+
+  // Frustum usado para priorizar a geração das malhas na tela
+  mat4 view_projection;
+  glm_mat4_mul((vec4*)camera_get_projection_matrix(), view_matrix,
+               view_projection);
+  glm_frustum_planes(view_projection, frustum_planes);
 
   // Obtém a posição atual do jogador para determinar os chunks visíveis
   vec3 player_position;
@@ -267,48 +495,84 @@ void renderer_draw_world() {
   int player_chunk_x = (int)(player_position[0] / CHUNK_WIDTH);
   int player_chunk_z = (int)(player_position[2] / CHUNK_DEPTH);
 
-  // Define o alcance de renderização ao redor do jogador
-  const int render_distance = 2;
+  // Os jobs já na fila passam a seguir a visão e a posição deste quadro
+  mesh_worker_reprioritize(requeue_priority, player_position);
+
+  // Chunks esparsos ficam para o fim, todos com o programa de instâncias
+  static Chunk*
+      instanced[(2 * RENDER_DISTANCE + 1) * (2 * RENDER_DISTANCE + 1)];
+  int instanced_count = 0;
+
+  // Chunks distantes usam uma malha mais grossa. Os níveis de todos os chunks
+  // mudam antes de qualquer job sair, para que cada snapshot já veja os
+  // vizinhos no nível deste quadro e nenhuma malha seja gerada duas vezes
+  for (int cx = player_chunk_x - RENDER_DISTANCE;
+       cx <= player_chunk_x + RENDER_DISTANCE; cx++) {
+    for (int cz = player_chunk_z - RENDER_DISTANCE;
+         cz <= player_chunk_z + RENDER_DISTANCE; cz++) {
+      Chunk* chunk = world_get_chunk(cx, cz);
+      if (chunk) {
+        chunk_set_lod(chunk,
+                      lod_for_chunk(cx, cz, player_chunk_x, player_chunk_z));
+      }
+    }
+  }
+  prefetch_chunks(player_position, player_chunk_x, player_chunk_z, 0);
 
-  for (int cx = player_chunk_x - render_distance;
-       cx <= player_chunk_x + render_distance; cx++) {
-    for (int cz = player_chunk_z - render_distance;
-         cz <= player_chunk_z + render_distance; cz++) {
+  for (int cx = player_chunk_x - RENDER_DISTANCE;
+       cx <= player_chunk_x + RENDER_DISTANCE; cx++) {
+    for (int cz = player_chunk_z - RENDER_DISTANCE;
+         cz <= player_chunk_z + RENDER_DISTANCE; cz++) {
       Chunk* chunk = world_get_chunk(cx, cz);
       if (!chunk) continue;  // Pula chunks não carregados
 
-      // Verifica se o chunk precisa ser atualizado
-      if (chunk->needs_update) {
-        chunk_update_mesh(chunk);  // Atualiza a malha do chunk
+      // Verifica se o chunk precisa ser atualizado; a malha é gerada no
+      // pool de trabalho, na ordem de prioridade, e aparece num dos próximos
+      // quadros
+      if (chunk->needs_update && !chunk->mesh_pending) {
+        mesh_worker_submit(chunk, mesh_priority(player_position, cx, cz));
       }
 
-      // Pula chunks vazios (sem índice para renderizar)
-      if (chunk->index_count == 0) continue;
+      if (chunk->instanced) {
+        if (chunk->instance_count > 0) instanced[instanced_count++] = chunk;
+        continue;
+      }
 
-      // Define a matriz modelo para o chunk
-      mat4 model;
-      glm_mat4_identity(model);
-      glm_translate(model, (vec3){cx * CHUNK_WIDTH, 0.0f, cz * CHUNK_DEPTH});
-      GLint modelLoc = glGetUniformLocation(shaderProgram, "model");
-      glUniformMatrix4fv(modelLoc, 1, GL_FALSE, (float*)model);
+      // Pula chunks vazios (sem quad para renderizar)
+      if (chunk->quad_count == 0) continue;
 
-      // Vincula o VAO do chunk e desenha
-      glBindVertexArray(chunk->vao);
+      // Define a origem do chunk
+      set_chunk_origin(origin_location, cx, cz);
 
       // Seleciona a textura correta (assumindo uma textura única no momento)
       glActiveTexture(GL_TEXTURE0);
       glBindTexture(GL_TEXTURE_2D, textures[0]);  // Ajuste se necessário
 
       // Renderiza o chunk
-      glDrawElements(GL_TRIANGLES, chunk->index_count, GL_UNSIGNED_INT, 0);
+      chunk_draw(chunk, player_position);
+    }
+  }
 
-      // Desvincula o VAO para evitar problemas futuros
-      glBindVertexArray(0);
+  if (instanced_count > 0) {
+    origin_location = set_view_uniforms(instancedProgram, view_matrix);
+    for (int i = 0; i < instanced_count; i++) {
+      set_chunk_origin(origin_location, instanced[i]->x, instanced[i]->z);
+      chunk_draw_instances(instanced[i]);
     }
   }
 
   // Desvincula o programa de shader
   glUseProgram(0);
+
+  // Com os chunks visíveis prontos, adianta os que estão no caminho
+  prefetch_chunks(player_position, player_chunk_x, player_chunk_z, 1);
+}
+
+// Programas de shader, refeitos a cada reset
+static void cleanup_programs() {
+  glDeleteProgram(shaderProgram);
+  glDeleteProgram(instancedProgram);
+  gpu_mesher_cleanup();
 }
 
 void renderer_cleanup() {
@@ -316,10 +580,14 @@ void renderer_cleanup() {
   glDeleteVertexArrays(1, &VAO);
   glDeleteBuffers(1, &VBO);
   glDeleteBuffers(1, &EBO);
-  glDeleteProgram(shaderProgram);
+  VAO = VBO = EBO = 0;
+  chunk_set_instance_cube(0, 0);
+  glDeleteTextures(3, textures);
+  memset(textures, 0, sizeof(textures));
+  cleanup_programs();
 }
 
 void renderer_reset() {
-  renderer_cleanup();
+  cleanup_programs();
   renderer_init();
 }
@@ -0,0 +1,119 @@
+// src/shader_cache.c
+//
+// Cache do programa de shader já linkado (glGetProgramBinary). O binário só
+// vale para o mesmo driver e o mesmo código-fonte, então a chave mistura as
+// strings do driver com o texto dos shaders. Se o driver rejeitar o binário
+// (atualização, outra GPU), quem chamou compila a partir do fonte.
+
+#include "shader_cache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cache.h"
+
+#define SHADER_CACHE_MAGIC 0x53505856  // "VXPS"
+#define SHADER_CACHE_VERSION 1
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t key;
+  uint32_t format;  // binaryFormat devolvido por glGetProgramBinary
+  uint32_t length;
+} ShaderCacheHeader;
+
+static void shader_cache_path(const char* name, char* path, size_t size) {
+  snprintf(path, size, "%s/%s.bin", CACHE_DIR, name);
+}
+
+int shader_cache_supported() {
+  if (!GLEW_VERSION_4_1 && !GLEW_ARB_get_program_binary) return 0;
+  GLint formats = 0;
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+  return formats > 0;
+}
+
+uint64_t shader_cache_key(const char* const* sources, int count) {
+  const GLenum driver_strings[] = {GL_VENDOR, GL_RENDERER, GL_VERSION};
+  uint64_t key = CACHE_HASH_SEED;
+  for (int i = 0; i < 3; i++) {
+    const char* value = (const char*)glGetString(driver_strings[i]);
+    if (value) key = cache_hash(value, strlen(value) + 1, key);
+  }
+  for (int i = 0; i < count; i++) {
+    if (sources[i]) key = cache_hash(sources[i], strlen(sources[i]) + 1, key);
+  }
+  return key;
+}
+
+// Devolve o programa carregado do cache, ou 0 se não houver um válido
+GLuint shader_cache_load(const char* name, uint64_t key) {
+  if (!shader_cache_supported()) return 0;
+
+  char path[512];
+  shader_cache_path(name, path, sizeof(path));
+
+  size_t size = 0;
+  unsigned char* data = cache_map(path, &size);
+  if (!data) return 0;
+
+  const ShaderCacheHeader* header = (const ShaderCacheHeader*)data;
+  if (size < sizeof(ShaderCacheHeader) ||
+      header->magic != SHADER_CACHE_MAGIC ||
+      header->version != SHADER_CACHE_VERSION || header->key != key ||
+      sizeof(ShaderCacheHeader) + header->length > size) {
+    cache_unmap(data, size);
+    return 0;
+  }
+
+  GLuint program = glCreateProgram();
+  glProgramBinary(program, header->format, data + sizeof(ShaderCacheHeader),
+                  header->length);
+  cache_unmap(data, size);
+
+  GLint success = 0;
+  glGetProgramiv(program, GL_LINK_STATUS, &success);
+  if (!success) {
+    // Binário recusado pelo driver; o chamador recompila e regrava o cache
+    glDeleteProgram(program);
+    return 0;
+  }
+  return program;
+}
+
+// Grava o binário de um programa recém-linkado. Para que o driver o guarde,
+// o programa deve ter sido linkado com GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+void shader_cache_store(const char* name, uint64_t key, GLuint program) {
+  if (!shader_cache_supported()) return;
+
+  GLint linked = 0;
+  glGetProgramiv(program, GL_LINK_STATUS, &linked);
+  if (!linked) return;
+
+  GLint length = 0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0) return;
+
+  unsigned char* data = malloc(sizeof(ShaderCacheHeader) + length);
+  if (!data) return;
+
+  ShaderCacheHeader* header = (ShaderCacheHeader*)data;
+  GLenum format = 0;
+  GLsizei written = 0;
+  glGetProgramBinary(program, length, &written, &format,
+                     data + sizeof(ShaderCacheHeader));
+  if (written > 0) {
+    header->magic = SHADER_CACHE_MAGIC;
+    header->version = SHADER_CACHE_VERSION;
+    header->key = key;
+    header->format = format;
+    header->length = written;
+
+    char path[512];
+    shader_cache_path(name, path, sizeof(path));
+    cache_write(path, data, sizeof(ShaderCacheHeader) + written);
+  }
+  free(data);
+}
@@ -0,0 +1,14 @@
+// src/shader_cache.h
+
+#ifndef SHADER_CACHE_H
+#define SHADER_CACHE_H
+
+#include <GL/glew.h>
+#include <stdint.h>
+
+int shader_cache_supported();
+uint64_t shader_cache_key(const char* const* sources, int count);
+GLuint shader_cache_load(const char* name, uint64_t key);
+void shader_cache_store(const char* name, uint64_t key, GLuint program);
+
+#endif  // SHADER_CACHE_H
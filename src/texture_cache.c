@@ -0,0 +1,232 @@
+// src/texture_cache.c
+//
+// Cache das texturas dos blocos já decodificadas, com a cadeia de mipmaps
+// completa, num único arquivo binário. Na primeira execução (ou quando algum
+// PNG muda) as imagens são decodificadas e o arquivo é gerado; nas seguintes
+// ele é mapeado em memória e enviado direto para a GPU.
+//
+// Layout do arquivo (todos os campos em uint32, ordem de bytes nativa):
+//   TextureCacheHeader
+//   TextureCacheEntry[texture_count]
+//   TextureCacheLevel[soma dos níveis de todas as texturas]
+//   pixels RGBA8 de cada nível, no offset indicado em TextureCacheLevel
+
+#include "texture_cache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cache.h"
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#define TEXTURE_CACHE_MAGIC 0x43545856  // "VXTC"
+#define TEXTURE_CACHE_VERSION 1
+#define TEXTURE_CACHE_MAX_LEVELS 16
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t key;  // Hash dos nomes, tamanhos e datas dos PNGs de origem
+  uint32_t texture_count;
+  uint32_t level_count;
+} TextureCacheHeader;
+
+typedef struct {
+  uint32_t first_level;
+  uint32_t level_count;
+} TextureCacheEntry;
+
+typedef struct {
+  uint32_t width, height;
+  uint32_t offset, size;
+} TextureCacheLevel;
+
+static uint64_t texture_cache_key(const char* const* files, int count) {
+  uint64_t key = CACHE_HASH_SEED;
+  for (int i = 0; i < count; i++) {
+    key = cache_hash(files[i], strlen(files[i]) + 1, key);
+    key = cache_hash_file_stamp(files[i], key);
+  }
+  return key;
+}
+
+// Confere se o arquivo mapeado é um cache válido para estas texturas
+static int texture_cache_validate(const unsigned char* data, size_t size,
+                                  uint64_t key, int count) {
+  if (size < sizeof(TextureCacheHeader)) return 0;
+  const TextureCacheHeader* header = (const TextureCacheHeader*)data;
+  if (header->magic != TEXTURE_CACHE_MAGIC ||
+      header->version != TEXTURE_CACHE_VERSION || header->key != key ||
+      header->texture_count != (uint32_t)count) {
+    return 0;
+  }
+
+  size_t tables = sizeof(TextureCacheHeader) +
+                  count * sizeof(TextureCacheEntry) +
+                  header->level_count * sizeof(TextureCacheLevel);
+  if (size < tables) return 0;
+
+  const TextureCacheEntry* entries =
+      (const TextureCacheEntry*)(data + sizeof(TextureCacheHeader));
+  const TextureCacheLevel* levels =
+      (const TextureCacheLevel*)(entries + count);
+  for (int i = 0; i < count; i++) {
+    if (entries[i].level_count == 0 ||
+        entries[i].first_level + entries[i].level_count > header->level_count) {
+      return 0;
+    }
+  }
+  for (uint32_t i = 0; i < header->level_count; i++) {
+    if ((size_t)levels[i].offset + levels[i].size > size ||
+        levels[i].size != levels[i].width * levels[i].height * 4) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// Reduz um nível RGBA8 pela metade com filtro de caixa 2x2
+static void downsample(const unsigned char* src, int width, int height,
+                       unsigned char* dst, int dst_width, int dst_height) {
+  for (int y = 0; y < dst_height; y++) {
+    for (int x = 0; x < dst_width; x++) {
+      int x0 = x * 2, y0 = y * 2;
+      int x1 = x0 + 1 < width ? x0 + 1 : x0;
+      int y1 = y0 + 1 < height ? y0 + 1 : y0;
+      for (int c = 0; c < 4; c++) {
+        int sum = src[(y0 * width + x0) * 4 + c] +
+                  src[(y0 * width + x1) * 4 + c] +
+                  src[(y1 * width + x0) * 4 + c] +
+                  src[(y1 * width + x1) * 4 + c];
+        dst[(y * dst_width + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+      }
+    }
+  }
+}
+
+// Decodifica os PNGs, gera os mipmaps e monta a imagem completa do arquivo
+static unsigned char* texture_cache_bake(const char* const* files, int count,
+                                         uint64_t key, size_t* out_size) {
+  unsigned char* images[count];
+  int widths[count], heights[count], level_counts[count];
+  uint32_t total_levels = 0;
+  size_t pixel_bytes = 0;
+
+  for (int i = 0; i < count; i++) {
+    int channels;
+    images[i] = stbi_load(files[i], &widths[i], &heights[i], &channels, 4);
+    if (!images[i]) {
+      fprintf(stderr, "Falha ao carregar a textura %s\n", files[i]);
+      for (int j = 0; j < i; j++) stbi_image_free(images[j]);
+      return NULL;
+    }
+
+    int w = widths[i], h = heights[i];
+    level_counts[i] = 0;
+    while (level_counts[i] < TEXTURE_CACHE_MAX_LEVELS) {
+      pixel_bytes += (size_t)w * h * 4;
+      level_counts[i]++;
+      if (w == 1 && h == 1) break;
+      w = w > 1 ? w / 2 : 1;
+      h = h > 1 ? h / 2 : 1;
+    }
+    total_levels += level_counts[i];
+  }
+
+  size_t data_offset = sizeof(TextureCacheHeader) +
+                       count * sizeof(TextureCacheEntry) +
+                       total_levels * sizeof(TextureCacheLevel);
+  size_t size = data_offset + pixel_bytes;
+  unsigned char* data = calloc(1, size);
+  if (!data) {
+    for (int i = 0; i < count; i++) stbi_image_free(images[i]);
+    return NULL;
+  }
+
+  TextureCacheHeader* header = (TextureCacheHeader*)data;
+  header->magic = TEXTURE_CACHE_MAGIC;
+  header->version = TEXTURE_CACHE_VERSION;
+  header->key = key;
+  header->texture_count = count;
+  header->level_count = total_levels;
+
+  TextureCacheEntry* entries =
+      (TextureCacheEntry*)(data + sizeof(TextureCacheHeader));
+  TextureCacheLevel* levels = (TextureCacheLevel*)(entries + count);
+
+  uint32_t level = 0;
+  size_t offset = data_offset;
+  for (int i = 0; i < count; i++) {
+    entries[i].first_level = level;
+    entries[i].level_count = level_counts[i];
+
+    int w = widths[i], h = heights[i];
+    for (int l = 0; l < level_counts[i]; l++, level++) {
+      levels[level].width = w;
+      levels[level].height = h;
+      levels[level].offset = offset;
+      levels[level].size = w * h * 4;
+
+      if (l == 0) {
+        memcpy(data + offset, images[i], levels[level].size);
+      } else {
+        const TextureCacheLevel* prev = &levels[level - 1];
+        downsample(data + prev->offset, prev->width, prev->height,
+                   data + offset, w, h);
+      }
+      offset += levels[level].size;
+      w = w > 1 ? w / 2 : 1;
+      h = h > 1 ? h / 2 : 1;
+    }
+    stbi_image_free(images[i]);
+  }
+
+  *out_size = size;
+  return data;
+}
+
+static void texture_cache_upload(const unsigned char* data, int count,
+                                 GLuint* textures) {
+  const TextureCacheEntry* entries =
+      (const TextureCacheEntry*)(data + sizeof(TextureCacheHeader));
+  const TextureCacheLevel* levels =
+      (const TextureCacheLevel*)(entries + count);
+
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  for (int i = 0; i < count; i++) {
+    glBindTexture(GL_TEXTURE_2D, textures[i]);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL,
+                    entries[i].level_count - 1);
+    for (uint32_t l = 0; l < entries[i].level_count; l++) {
+      const TextureCacheLevel* level = &levels[entries[i].first_level + l];
+      glTexImage2D(GL_TEXTURE_2D, l, GL_RGBA8, level->width, level->height, 0,
+                   GL_RGBA, GL_UNSIGNED_BYTE, data + level->offset);
+    }
+  }
+}
+
+// Carrega as texturas (já criadas com glGenTextures) a partir do cache,
+// gerando-o antes se estiver ausente ou desatualizado
+int texture_cache_load(const char* const* files, int count, GLuint* textures) {
+  uint64_t key = texture_cache_key(files, count);
+
+  size_t size = 0;
+  unsigned char* mapped = cache_map(TEXTURE_CACHE_FILE, &size);
+  if (mapped && texture_cache_validate(mapped, size, key, count)) {
+    texture_cache_upload(mapped, count, textures);
+    cache_unmap(mapped, size);
+    return 1;
+  }
+  cache_unmap(mapped, size);
+
+  unsigned char* baked = texture_cache_bake(files, count, key, &size);
+  if (!baked) return 0;
+
+  texture_cache_upload(baked, count, textures);
+  cache_write(TEXTURE_CACHE_FILE, baked, size);
+  free(baked);
+  return 1;
+}
@@ -0,0 +1,14 @@
+// src/texture_cache.h
+
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include <GL/glew.h>
+
+#include "cache.h"
+
+#define TEXTURE_CACHE_FILE CACHE_DIR "/textures.bin"
+
+int texture_cache_load(const char* const* files, int count, GLuint* textures);
+
+#endif  // TEXTURE_CACHE_H
@@ -4,11 +4,17 @@
 
 #include <stdlib.h>
 
+#include "mesh_cache.h"
+#include "mesher.h"
+
 #define WORLD_SIZE 3  // Mundo de 3x3 chunks
 
 static Chunk* chunks[WORLD_SIZE][WORLD_SIZE];
 
 void world_init() {
+  chunk_init_quad_indices();
+  mesh_cache_load();  // Malhas da sessão anterior
+
   // Inicializa os chunks
   for (int x = 0; x < WORLD_SIZE; x++) {
     for (int z = 0; z < WORLD_SIZE; z++) {
@@ -24,6 +30,11 @@ void world_cleanup() {
       chunk_destroy(chunks[x][z]);
     }
   }
+  chunk_cleanup_quad_indices();
+  mesher_free_scratch();
+  mesh_cache_report();
+  mesh_cache_save();
+  mesh_cache_clear();
 }
 
 Chunk* world_get_chunk(int x, int z) {
@@ -80,6 +91,29 @@ void world_set_block(int x, int y, int z, BlockType type) {
   Block* block = chunk_get_block(chunk, local_x, y, local_z);
   block->type = type;
 
-  // Marca o chunk como precisando de atualização
-  chunk->needs_update = 1;
+  // Marca a seção do chunk (e a vizinha, numa fronteira) para refazer a malha
+  chunk_mark_dirty(chunk, y);
+
+  // Blocos perto da borda também mudam a face visível do chunk vizinho: no
+  // nível de detalhe dele, a célula encostada na borda lê 1 << lod colunas
+  // deste chunk (ver halo_*_inner em ChunkSnapshot)
+  Chunk* neighbor = world_get_chunk(chunk_x - 1, chunk_z);
+  if (neighbor && local_x < (1 << neighbor->lod)) {
+    chunk_mark_dirty(neighbor, y);
+  }
+
+  neighbor = world_get_chunk(chunk_x + 1, chunk_z);
+  if (neighbor && local_x >= CHUNK_WIDTH - (1 << neighbor->lod)) {
+    chunk_mark_dirty(neighbor, y);
+  }
+
+  neighbor = world_get_chunk(chunk_x, chunk_z - 1);
+  if (neighbor && local_z < (1 << neighbor->lod)) {
+    chunk_mark_dirty(neighbor, y);
+  }
+
+  neighbor = world_get_chunk(chunk_x, chunk_z + 1);
+  if (neighbor && local_z >= CHUNK_DEPTH - (1 << neighbor->lod)) {
+    chunk_mark_dirty(neighbor, y);
+  }
 }